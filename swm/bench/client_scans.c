@@ -0,0 +1,76 @@
+/// Client scan benchmark, built and run by `make bench`.
+///
+/// Times the client list scans of an arrange and a bar redraw over 1000
+/// clients which only exist in memory, all tags in view. An arrange is
+/// `Monitor__arrange` finding the layout of the tags in its cache, which
+/// hashes the layout inputs and checks the geometry of every tiled client.
+/// The bar draws from the tag masks which `Monitor__count_client` keeps up
+/// to date, what a tag, floating or urgency change costs. The drawing
+/// itself needs a running X server and is left out.
+
+// Standard Libraries
+#include <stdint.h>
+#include <stdio.h>
+
+// Slacker Headers
+#include "bench.h"
+#include "client.h"
+#include "config.h"
+#include "monitor.h"
+#include "pool.h"
+#include "swm.h"
+#include "timing.h"
+#include "utils.h"
+
+#define BENCH_CLIENTS 1000
+#define BENCH_ROUNDS 1000
+
+static double per_client_ns(uint64_t us)
+{
+	return us * 1000.0 / ((double)BENCH_ROUNDS * BENCH_CLIENTS);
+}
+
+int main(void)
+{
+	Monitor *monitor = NULL;
+	Client *c = NULL;
+	volatile uint32_t sink = 0;
+	uint64_t start_us = 0;
+	uint64_t arrange_us = 0;
+	uint64_t count_us = 0;
+
+	Pool__init(&g_swm.client_pool, "client", sizeof(Client));
+	Pool__init(&g_swm.monitor_pool, "monitor", sizeof(Monitor));
+	monitor = Bench__monitor();
+	Bench__populate(monitor, BENCH_CLIENTS);
+	// Lays the clients out once, the arranges below hit the cache
+	Monitor__view(monitor, TAGMASK);
+
+	start_us = Timing__now_us();
+	for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+		Monitor__arrange(monitor);
+		sink += monitor->layout_symbol[0];
+	}
+	arrange_us = Timing__now_us() - start_us;
+
+	start_us = Timing__now_us();
+	for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+		for (c = monitor->client_list; c; c = c->next) {
+			Monitor__count_client(monitor, c, 1);
+			Monitor__count_client(monitor, c, -1);
+		}
+		sink += monitor->occupied_tags;
+	}
+	count_us = Timing__now_us() - start_us;
+
+	fprintf(stdout,
+		"client scans over %u clients (%zu bytes each): arrange %.2f, "
+		"count %.2f ns per client\n",
+		BENCH_CLIENTS, sizeof(Client), per_client_ns(arrange_us),
+		per_client_ns(count_us));
+
+	Bench__delete(monitor);
+	Pool__delete(&g_swm.client_pool);
+	Pool__delete(&g_swm.monitor_pool);
+	return 0;
+}
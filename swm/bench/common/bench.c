@@ -0,0 +1,70 @@
+/// Shared setup of the benchmarks, linked into every one of them.
+
+// Slacker Headers
+#include "bench.h"
+#include "client.h"
+#include "config.h"
+#include "pool.h"
+#include "swm.h"
+#include "utils.h"
+
+/// @brief Stacks the tiled clients, one row each, without the server.
+static void Bench__layout_rows(Monitor *monitor)
+{
+	int32_t y = monitor->wy;
+
+	for (Client *c = Client__next_tiled(monitor->client_list); c;
+	     c = Client__next_tiled(c->next), ++y) {
+		c->x = monitor->wx;
+		c->y = y;
+		c->w = monitor->ww;
+		c->h = 1;
+	}
+}
+
+static const Layout s_bench_layout = { "[=]", Bench__layout_rows };
+
+Monitor *Bench__monitor(void)
+{
+	Monitor *monitor = Monitor__new();
+
+	monitor->layouts[0] = &s_bench_layout;
+	for (uint32_t i = 0; i < LENGTH(monitor->tag_state); ++i) {
+		monitor->tag_state[i].layouts[0] = &s_bench_layout;
+	}
+	monitor->next = g_swm.monitor_list;
+	g_swm.monitor_list = g_swm.selected_monitor = monitor;
+	return monitor;
+}
+
+void Bench__populate(Monitor *monitor, uint32_t num_clients)
+{
+	Client *c = NULL;
+
+	for (uint32_t i = 0; i < num_clients; ++i) {
+		c = Pool__alloc(&g_swm.client_pool);
+		c->mon = monitor;
+		c->win = i + 1;
+		c->tags = 1 << (i % LENGTH(G_TAGS));
+		c->isfloating = i % 7 == 0;
+		c->isurgent = i % 50 == 0;
+		c->hidden = !ISVISIBLE(c);
+		Client__attach(c);
+		Client__attach_to_stack(c);
+	}
+}
+
+void Bench__delete(Monitor *monitor)
+{
+	Client *c = NULL;
+
+	while ((c = monitor->client_list)) {
+		Client__detach(c);
+		Client__detach_from_stack(c);
+		Pool__free(&g_swm.client_pool, c);
+	}
+	if (g_swm.selected_monitor == monitor) {
+		g_swm.selected_monitor = NULL;
+	}
+	Monitor__delete(monitor);
+}
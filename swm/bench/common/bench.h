@@ -0,0 +1,26 @@
+#ifndef SWM_BENCH_H
+#define SWM_BENCH_H
+
+// Standard Libraries
+#include <stdint.h>
+
+// Slacker Headers
+#include "monitor.h"
+
+/// @brief Builds a monitor which only exists in memory.
+///
+/// @details The monitor is put into the monitor list and selected. All its
+/// tags use a layout which places the clients without the server, so
+/// `Monitor__arrange` runs without one.
+Monitor *Bench__monitor(void);
+
+/// @brief Attaches clients spread over the tags to a bench monitor.
+///
+/// @details Every 7th client floats and every 50th is urgent. Clients off
+/// the tags in view are parked, as `Swm__showhide` would leave them.
+void Bench__populate(Monitor *monitor, uint32_t num_clients);
+
+/// @brief Frees the clients of a bench monitor, then deletes it.
+void Bench__delete(Monitor *monitor);
+
+#endif // SWM_BENCH_H
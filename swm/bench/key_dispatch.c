@@ -0,0 +1,99 @@
+/// Key dispatch benchmark, built and run by `make bench`.
+///
+/// Compares the dispatch table `Swm__grab_keys` fills with scanning every
+/// binding for each keypress, the way keys were dispatched before. Needs no
+/// X server, every bound keysym gets a made up keycode.
+
+// Standard Libraries
+#include <stdint.h>
+#include <stdio.h>
+
+// Slacker Headers
+#include "config.h"
+#include "swm.h"
+#include "timing.h"
+#include "utils.h"
+
+#define BENCH_ROUNDS 100000
+/// X servers start numbering keycodes at 8
+#define BENCH_FIRST_KEYCODE 8
+
+int main(void)
+{
+	KeySym keymap[MAX_KEYCODES] = { NoSymbol };
+	KeyCode keycodes[MAX_KEY_BINDINGS] = { 0 };
+	uint32_t num_keycodes = BENCH_FIRST_KEYCODE;
+	uint32_t presses = 0;
+	uint32_t k = 0;
+	volatile uint32_t sink = 0;
+	uint64_t start_us = 0;
+	uint64_t table_us = 0;
+	uint64_t scan_us = 0;
+	KeySym keysym = NoSymbol;
+
+	// One keycode per distinct keysym, like a keyboard mapping would
+	for (uint32_t i = 0; i < LENGTH(G_KEYBINDINGS); ++i) {
+		if (!G_KEYBINDINGS[i].handler) {
+			continue;
+		}
+		for (k = BENCH_FIRST_KEYCODE;
+		     k < num_keycodes && keymap[k] != G_KEYBINDINGS[i].keysym;
+		     ++k) {
+			;
+		}
+		if (k == num_keycodes) {
+			if (num_keycodes == MAX_KEYCODES) {
+				continue;
+			}
+			keymap[num_keycodes++] = G_KEYBINDINGS[i].keysym;
+		}
+		keycodes[i] = k;
+		Swm__add_key_dispatch(k, i);
+		++presses;
+	}
+	if (!presses) {
+		fprintf(stdout, "key dispatch: no key bindings\n");
+		return 0;
+	}
+
+	start_us = Timing__now_us();
+	for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+		for (uint32_t i = 0; i < LENGTH(G_KEYBINDINGS); ++i) {
+			if (!keycodes[i]) {
+				continue;
+			}
+			for (uint8_t b = g_swm.key_dispatch[keycodes[i]][CLEANMASK(
+				     G_KEYBINDINGS[i].mod)];
+			     b; b = g_swm.key_dispatch_next[b - 1]) {
+				sink += b;
+			}
+		}
+	}
+	table_us = Timing__now_us() - start_us;
+
+	start_us = Timing__now_us();
+	for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+		for (uint32_t i = 0; i < LENGTH(G_KEYBINDINGS); ++i) {
+			if (!keycodes[i]) {
+				continue;
+			}
+			keysym = keymap[keycodes[i]];
+			for (uint32_t j = 0; j < LENGTH(G_KEYBINDINGS); ++j) {
+				if (keysym == G_KEYBINDINGS[j].keysym &&
+				    CLEANMASK(G_KEYBINDINGS[j].mod) ==
+					    CLEANMASK(G_KEYBINDINGS[i].mod) &&
+				    G_KEYBINDINGS[j].handler) {
+					sink += j;
+				}
+			}
+		}
+	}
+	scan_us = Timing__now_us() - start_us;
+
+	fprintf(stdout,
+		"key dispatch over %u bindings: table %.1f ns, "
+		"scan %.1f ns per keypress\n",
+		presses, table_us * 1000.0 / (presses * BENCH_ROUNDS),
+		scan_us * 1000.0 / (presses * BENCH_ROUNDS));
+	return 0;
+}
@@ -0,0 +1,64 @@
+/// Tag switch benchmark, built and run by `make bench`.
+///
+/// Times `Monitor__view`, what `Swm__view` does besides talking to the
+/// server, with 50, 200 and 1000 clients spread over the tags: saving and
+/// loading the tag state, the layout cache lookup of `Monitor__arrange` and
+/// the focus fallback walk of the stack. The show and hide pass, the
+/// restack and the focus requests need a running X server and are left out.
+
+// Standard Libraries
+#include <stdint.h>
+#include <stdio.h>
+
+// Slacker Headers
+#include "bench.h"
+#include "client.h"
+#include "config.h"
+#include "monitor.h"
+#include "pool.h"
+#include "swm.h"
+#include "timing.h"
+#include "utils.h"
+
+#define BENCH_SWITCHES 100000
+
+static void bench(uint32_t num_clients)
+{
+	Monitor *monitor = Bench__monitor();
+	volatile uintptr_t sink = 0;
+	uint64_t start_us = 0;
+	uint64_t elapsed_us = 0;
+
+	Bench__populate(monitor, num_clients);
+
+	// Every tag was laid out once, the switches below hit the cache
+	for (uint32_t i = 0; i < LENGTH(G_TAGS); ++i) {
+		Monitor__view(monitor, 1 << i);
+	}
+
+	start_us = Timing__now_us();
+	for (uint32_t i = 0; i < BENCH_SWITCHES; ++i) {
+		sink += (uintptr_t)Monitor__view(monitor,
+						 1 << (i % LENGTH(G_TAGS)));
+	}
+	elapsed_us = Timing__now_us() - start_us;
+
+	fprintf(stdout, "view with %4u clients: %.3f us per tag switch\n",
+		num_clients, (double)elapsed_us / BENCH_SWITCHES);
+
+	Bench__delete(monitor);
+}
+
+int main(void)
+{
+	const uint32_t sizes[] = { 50, 200, 1000 };
+
+	Pool__init(&g_swm.client_pool, "client", sizeof(Client));
+	Pool__init(&g_swm.monitor_pool, "monitor", sizeof(Monitor));
+	for (uint32_t i = 0; i < LENGTH(sizes); ++i) {
+		bench(sizes[i]);
+	}
+	Pool__delete(&g_swm.client_pool);
+	Pool__delete(&g_swm.monitor_pool);
+	return 0;
+}
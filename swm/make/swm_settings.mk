@@ -12,15 +12,31 @@ FREETYPEINC = /usr/include/freetype2
 #FREETYPEINC = ${X11INC}/freetype2
 #MANPREFIX = ${PREFIX}/man
 
+# Xrandr, used for refresh rates and physical monitors.
+# Detected through pkg-config, build with XRANDR=0 to leave it out.
+XRANDR ?= $(shell pkg-config --exists xrandr && echo 1 || echo 0)
+ifeq ($(XRANDR), 1)
+	XRANDRLIBS = -lXrandr
+	XRANDRFLAGS = -DXRANDR
+endif
+
+# Xinerama, fallback for servers without RandR 1.5.
+# Detected through pkg-config, build with XINERAMA=0 to leave it out.
+XINERAMA ?= $(shell pkg-config --exists xinerama && echo 1 || echo 0)
+ifeq ($(XINERAMA), 1)
+	XINERAMALIBS = -lXinerama
+	XINERAMAFLAGS = -DXINERAMA
+endif
+
 # includes and libs
 INCS = -I${X11INC} -I${FREETYPEINC}
-LIBS = -L${X11LIB} -lX11 ${FREETYPELIBS}
+LIBS = -L${X11LIB} -lX11 -lXext ${XRANDRLIBS} ${XINERAMALIBS} ${FREETYPELIBS} -lpthread
 
 TARGET?=swm
 
 # flags
 DEBUG?=0
-ARGUMENT_FLAGS = -D_DEFAULT_SOURCE -D_BSD_SOURCE -D_XOPEN_SOURCE=700L -DVERSION=\"$(VERSION)\" -DDEBUG=$(DEBUG)
+ARGUMENT_FLAGS = -D_DEFAULT_SOURCE -D_BSD_SOURCE -D_XOPEN_SOURCE=700L -DVERSION=\"$(VERSION)\" -DDEBUG=$(DEBUG) ${XRANDRFLAGS} ${XINERAMAFLAGS}
 ifeq ($(DEBUG), 0)
 	CFLAGS = -std=c99 -pedantic -Wall -Wno-deprecated-declarations -Os ${INCS} ${ARGUMENT_FLAGS}
 else
@@ -1,62 +1,248 @@
+// Standard Libraries
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 // Slacker Headers
 #include "autostart.h"
+#include "timing.h"
 #include "utils.h"
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
+
+/// Write end of the self pipe, the signal handler can't reach the struct
+static int32_t s_sigchld_fd = -1;
+
+static void Autostart__sigchld(int32_t signum)
+{
+	int32_t saved_errno = errno;
+	char byte = 0;
+
+	// A full pipe already wakes up the event loop
+	if (write(s_sigchld_fd, &byte, 1) < 0) {
+		;
+	}
+	errno = saved_errno;
+}
+
+/// @brief Milliseconds since `Autostart__exec`, for the startup report.
+static double Autostart__elapsed_ms(const Autostart *as, uint64_t now_us)
+{
+	return (now_us - as->epoch_us) / 1000.0;
+}
+
+static void Autostart__start(Autostart *as, AutostartCommand *command)
+{
+	uint64_t now_us = Timing__now_us();
+
+	command->started = true;
+	command->restart_us = 0;
+	if (system_exec(command->cmd, &command->pid) < 0) {
+		fprintf(stderr, "autostart: '%s' failed to start: %s\n",
+			command->cmd, strerror(errno));
+		command->pid = -1;
+		// Don't hold back the commands waiting for it
+		command->finished = true;
+		return;
+	}
+	command->start_us = Timing__now_us();
+	fprintf(stdout,
+		"autostart: '%s' started at +%.1f ms, pid %d (spawn %.2f ms)\n",
+		command->cmd, Autostart__elapsed_ms(as, command->start_us),
+		(int)command->pid, (command->start_us - now_us) / 1000.0);
+}
+
+/// @brief Whether the dependency of a command allows it to start.
+static bool Autostart__ready(const Autostart *as,
+			     const AutostartCommand *command)
+{
+	const AutostartCommand *after = NULL;
+
+	if (command->started) {
+		return false;
+	}
+	if (command->after < 0) {
+		return true;
+	}
+
+	after = &as->cmds[command->after];
+	return after->finished ||
+	       (after->policy == SlackerAutostart_Restart && after->started);
+}
+
+static void Autostart__start_ready(Autostart *as)
+{
+	bool started = false;
+
+	// Starting a command that fails finishes it, which may unblock
+	// commands added before it
+	do {
+		started = false;
+		for (uint32_t i = 0; i < as->size; ++i) {
+			if (Autostart__ready(as, &as->cmds[i])) {
+				Autostart__start(as, &as->cmds[i]);
+				started = true;
+			}
+		}
+	} while (started);
+}
+
+/// @brief Records the exit of a supervised child and schedules its restart.
+static void Autostart__exited(Autostart *as, AutostartCommand *command,
+			      int32_t status, uint64_t now_us)
+{
+	uint64_t ran_ms = (now_us - command->start_us) / 1000;
+
+	command->pid = -1;
+	fprintf(stdout, "autostart: '%s' exited with %d after %.1f ms\n",
+		command->cmd,
+		WIFEXITED(status) ? WEXITSTATUS(status) : -WTERMSIG(status),
+		(now_us - command->start_us) / 1000.0);
+
+	// Don't restart a command the shell could not find
+	if (command->policy != SlackerAutostart_Restart || as->stopping ||
+	    (WIFEXITED(status) && WEXITSTATUS(status) == 127)) {
+		command->finished = true;
+		return;
+	}
+
+	// A daemon which ran for a while crashed, otherwise it keeps failing
+	if (ran_ms >= AUTOSTART_STABLE_MS || !command->backoff_ms) {
+		command->backoff_ms = AUTOSTART_BACKOFF_MIN_MS;
+	} else if ((command->backoff_ms *= 2) > AUTOSTART_BACKOFF_MAX_MS) {
+		command->backoff_ms = AUTOSTART_BACKOFF_MAX_MS;
+	}
+	command->restart_us = now_us + command->backoff_ms * 1000;
+	command->restarts += 1;
+	fprintf(stdout, "autostart: restarting '%s' in %lu ms (restart %u)\n",
+		command->cmd, (unsigned long)command->backoff_ms,
+		command->restarts);
+}
 
 Autostart Autostart__new(void)
 {
 	Autostart as = {
-		.cmds = { 0 },
-		.pids = { -1 },
+		.cmds = { { 0 } },
 		.size = 0,
+		.sigchld_pipe = { -1, -1 },
+		.epoch_us = 0,
+		.stopping = false,
 	};
 	return as;
 }
 
-void Autostart__add(Autostart *as, const char *cmd)
+int32_t Autostart__add(Autostart *as, const char *cmd, uint32_t policy,
+		       int32_t after)
 {
-	if (!as || !cmd) {
-		return;
-	}
+	AutostartCommand *command = NULL;
 
-	if (as->size < MAX_AUTOSTART_COMMANDS + 1) {
-		as->cmds[as->size++] = (char *)cmd;
-		as->pids[as->size] = -1;
-		as->size += 1;
+	if (!as || !cmd || as->size >= MAX_AUTOSTART_COMMANDS) {
+		return -1;
+	}
+	// Only earlier commands, so the order can't loop
+	if (after >= (int32_t)as->size) {
+		after = -1;
 	}
+
+	command = &as->cmds[as->size];
+	command->cmd = cmd;
+	command->policy = policy;
+	command->after = after;
+	command->pid = -1;
+	return as->size++;
 }
 
-/// Function to execute shell commands and store their PIDS
 void Autostart__exec(Autostart *as)
 {
+	struct sigaction sa;
+
 	if (!as) {
 		return;
 	}
-	char buffer[MAX_AUTOSTART_COMMANDS] = { 0 };
+	as->epoch_us = Timing__now_us();
+
+	if (pipe(as->sigchld_pipe) < 0) {
+		die("pipe:");
+	}
+	for (uint32_t i = 0; i < 2; ++i) {
+		fcntl(as->sigchld_pipe[i], F_SETFL, O_NONBLOCK);
+		fcntl(as->sigchld_pipe[i], F_SETFD, FD_CLOEXEC);
+	}
+	s_sigchld_fd = as->sigchld_pipe[1];
+
+	// Replaces the ignored SIGCHLD from `clean_environment`, the exit
+	// status is needed to restart daemons. Every child is reaped in
+	// `Autostart__supervise` instead.
+	sigemptyset(&sa.sa_mask);
+	sa.sa_flags = SA_NOCLDSTOP | SA_RESTART;
+	sa.sa_handler = Autostart__sigchld;
+	sigaction(SIGCHLD, &sa, NULL);
+
+	Autostart__start_ready(as);
+}
+
+int32_t Autostart__fd(const Autostart *as)
+{
+	return as ? as->sigchld_pipe[0] : -1;
+}
+
+uint64_t Autostart__deadline_us(const Autostart *as)
+{
+	uint64_t deadline_us = 0;
+
+	if (!as) {
+		return 0;
+	}
 
 	for (uint32_t i = 0; i < as->size; ++i) {
-		if (as->cmds[i] != NULL) {
-			strcat(buffer, as->cmds[i]);
-		} else {
-			if (buffer[0] != '\0') {
-				if (system_exec(buffer, &as->pids[i]) < 0) {
-					fprintf(stderr,
-						"'%s' failed to start\n",
-						buffer);
-					as->pids[i] = -1;
-				}
-
-				// We need to reset the buffer for the next command to be loaded in.
-				memset(buffer, 0, sizeof(buffer));
-				buffer[0] = '\0';
+		if (as->cmds[i].restart_us &&
+		    (!deadline_us || as->cmds[i].restart_us < deadline_us)) {
+			deadline_us = as->cmds[i].restart_us;
+		}
+	}
+	return deadline_us;
+}
+
+void Autostart__supervise(Autostart *as)
+{
+	char buffer[64];
+	int32_t status = 0;
+	uint64_t now_us = 0;
+	pid_t pid = 0;
+
+	if (!as || as->sigchld_pipe[0] < 0) {
+		return;
+	}
+
+	while (read(as->sigchld_pipe[0], buffer, sizeof(buffer)) > 0) {
+		;
+	}
+
+	now_us = Timing__now_us();
+	while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+		for (uint32_t i = 0; i < as->size; ++i) {
+			if (as->cmds[i].pid == pid) {
+				Autostart__exited(as, &as->cmds[i], status,
+						  now_us);
+				break;
 			}
 		}
 	}
+
+	if (as->stopping) {
+		return;
+	}
+	for (uint32_t i = 0; i < as->size; ++i) {
+		if (as->cmds[i].restart_us &&
+		    as->cmds[i].restart_us <= now_us) {
+			Autostart__start(as, &as->cmds[i]);
+		}
+	}
+	Autostart__start_ready(as);
 }
 
-/// @brief Iterate through all the stored PIDS of start up programs and kill
+/// @brief Iterate through all the running autostart commands and kill
 /// them.
 void Autostart__kill(Autostart *as)
 {
@@ -64,17 +250,22 @@ void Autostart__kill(Autostart *as)
 		return;
 	}
 
+	as->stopping = true;
 	for (uint32_t i = 0; i < as->size; ++i) {
-		// The `as->size` variable contains null entries to seperate
-		// commands. The pid array will hold no such null seperator values.
-		// Basically ever odd index of the pid array will hold a real pid,
-		// so if pid % 2 is 1, we have an odd index
-		if ((as->pids[i] % 2 == 1) && as->pids[i] > 0) {
-			kill(as->pids[i], SIGTERM);
-			waitpid(as->pids[i], NULL, WNOHANG);
+		as->cmds[i].restart_us = 0;
+		if (as->cmds[i].pid > 0) {
+			kill(as->cmds[i].pid, SIGTERM);
+			waitpid(as->cmds[i].pid, NULL, WNOHANG);
+			as->cmds[i].pid = -1;
+		}
+	}
+
+	for (uint32_t i = 0; i < 2; ++i) {
+		if (as->sigchld_pipe[i] >= 0) {
+			close(as->sigchld_pipe[i]);
+			as->sigchld_pipe[i] = -1;
 		}
 	}
-	memset(as->cmds, 0, sizeof(as->cmds));
-	memset(as->pids, 0, sizeof(as->pids));
+	s_sigchld_fd = -1;
 	as->size = 0;
 }
@@ -2,7 +2,8 @@
 #define SWM_AUTOSTART_H
 
 // Standard Libraries
-#include <bits/stdint-uintn.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <unistd.h>
@@ -10,16 +11,53 @@
 // Slacker Headers
 #include "constants.h"
 
+typedef struct AutostartCommand AutostartCommand;
 typedef struct Autostart Autostart;
 
-/// Holds the auto start shell commands
+/// What happens when an autostart command exits
+enum SlackerAutostart {
+	// Runs once, e.g `xrandr` or `feh`
+	SlackerAutostart_Once,
+	// A daemon which is started again with backoff, e.g `picom`
+	SlackerAutostart_Restart,
+};
+
+/// One supervised shell command
+struct AutostartCommand {
+	/// The shell command, run with `/bin/sh -c`
+	const char *cmd;
+	/// SlackerAutostart
+	uint32_t policy;
+	/// Id of the command which has to finish first, -1 for none
+	int32_t after;
+	/// Process id while running, -1 otherwise
+	pid_t pid;
+	/// The command has been started at least once
+	bool started;
+	/// A SlackerAutostart_Once command exited or failed to start
+	bool finished;
+	/// Monotonic time in microseconds of the last start
+	uint64_t start_us;
+	/// Monotonic time in microseconds to restart at, 0 if not scheduled
+	uint64_t restart_us;
+	/// Delay before the next restart
+	uint64_t backoff_ms;
+	/// Number of restarts so far
+	uint32_t restarts;
+};
+
+/// Supervises the auto start shell commands
 struct Autostart {
-	// Enter commands here, NULL terminated
-	char *cmds[MAX_AUTOSTART_COMMANDS];
-	// process id array
-	pid_t pids[MAX_AUTOSTART_COMMANDS];
+	AutostartCommand cmds[MAX_AUTOSTART_COMMANDS];
 	// Holds the number of commands added
 	uint32_t size;
+	// Self pipe written by the SIGCHLD handler, -1 until `Autostart__exec`
+	int32_t sigchld_pipe[2];
+	// Monotonic time in microseconds of `Autostart__exec`, start times
+	// are reported relative to it
+	uint64_t epoch_us;
+	// Set by `Autostart__kill`, nothing is restarted anymore
+	bool stopping;
 };
 
 /// @brief Initialize the Autostart struct
@@ -28,17 +66,43 @@ Autostart Autostart__new(void);
 /// @brief A simple interface which allows the user to add shell commands
 /// that will be executed when the window manager starts up.
 ///
+/// @details Commands without an `after` dependency start concurrently.
+///
 /// @param as: instance of the Autostart struct, (must be initialized)
 /// @param cmd: the shell command to be executed
-void Autostart__add(Autostart *as, const char *cmd);
+/// @param policy: SlackerAutostart, whether to restart the command
+/// @param after: id of a command to wait for, -1 for none. Waits for a
+/// SlackerAutostart_Once command to exit, a restarted one only to start.
+///
+/// @returns The id of the command, -1 if it could not be added
+int32_t Autostart__add(Autostart *as, const char *cmd, uint32_t policy,
+		       int32_t after);
 
-/// @brief Function to execute shell commands and store their PIDS
+/// @brief Starts supervising children and launches every command which
+/// doesn't wait for another one.
 ///
 /// @param as: instance of the Autostart struct, (must be initialized)
 void Autostart__exec(Autostart *as);
 
-/// @brief Iterate through all the stored PIDS of start up programs
-/// and kills them.
+/// @brief File descriptor which becomes readable when a child exits.
+///
+/// @returns The descriptor, -1 if children aren't supervised
+int32_t Autostart__fd(const Autostart *as);
+
+/// @brief The next time a restart is due.
+///
+/// @returns Monotonic time in microseconds, 0 if nothing is scheduled
+uint64_t Autostart__deadline_us(const Autostart *as);
+
+/// @brief Reaps exited children, then starts commands whose dependency
+/// finished and restarts daemons whose backoff passed.
+///
+/// @details Called from the event loop whenever it wakes up. Reaps every
+/// child, including the ones from `Swm__spawn`.
+void Autostart__supervise(Autostart *as);
+
+/// @brief Iterate through all the running autostart commands and kill
+/// them, without restarting.
 ///
 /// @param as: instance of the Autostart struct, (must be initialized)
 void Autostart__kill(Autostart *as);
@@ -0,0 +1,82 @@
+// Standard Libraries
+#include <stdio.h>
+#include <stdlib.h>
+
+// Slacker Headers
+#include "barscale.h"
+#include "config.h"
+#include "swm.h"
+#include "utils.h"
+
+/// @brief Hash of a string, never 0 so 0 can mark an empty slot
+static uint64_t BarScale__hash(const char *text)
+{
+	uint64_t hash = fnv1a_string(text);
+
+	return hash ? hash : 1;
+}
+
+/// @brief Loads G_USER_FONT with its size multiplied by `scale`.
+static Fnt *BarScale__load_fonts(double scale)
+{
+	char name[MAX_FONT_NAME_LEN];
+
+	if (scale == 1) {
+		return drw_fontset_create(g_swm.draw, G_USER_FONT);
+	}
+
+	// Xft multiplies the pixel size of the font by its scale property
+	snprintf(name, sizeof(name), "%s:scale=%.2f", G_USER_FONT, scale);
+	return drw_fontset_create(g_swm.draw, name);
+}
+
+BarScale *BarScale__get(double scale)
+{
+	BarScale *bar_scale = NULL;
+	Fnt *fonts = NULL;
+
+	for (bar_scale = g_swm.bar_scales; bar_scale;
+	     bar_scale = bar_scale->next) {
+		if (bar_scale->scale == scale) {
+			return bar_scale;
+		}
+	}
+
+	if (!(fonts = BarScale__load_fonts(scale))) {
+		return scale == 1 ? NULL : BarScale__get(1);
+	}
+
+	bar_scale = ecalloc(1, sizeof(BarScale));
+	bar_scale->scale = scale;
+	bar_scale->fonts = fonts;
+	bar_scale->bar_height = fonts->h + 5;
+	bar_scale->left_right_padding_sum = fonts->h + 5;
+	bar_scale->next = g_swm.bar_scales;
+	g_swm.bar_scales = bar_scale;
+	return bar_scale;
+}
+
+uint32_t BarScale__text_width(BarScale *bar_scale, const char *text)
+{
+	uint64_t hash = BarScale__hash(text);
+	BarScaleWidth *slot = &bar_scale->widths[hash % TEXT_WIDTH_CACHE_SIZE];
+
+	if (slot->hash != hash) {
+		drw_setfontset(g_swm.draw, bar_scale->fonts);
+		slot->hash = hash;
+		slot->width = drw_fontset_getwidth(g_swm.draw, text) +
+			      bar_scale->left_right_padding_sum + 2;
+	}
+	return slot->width;
+}
+
+void BarScale__delete_all(void)
+{
+	BarScale *bar_scale = NULL;
+
+	while ((bar_scale = g_swm.bar_scales)) {
+		g_swm.bar_scales = bar_scale->next;
+		drw_fontset_free(bar_scale->fonts);
+		free(bar_scale);
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef SWM_BARSCALE_H
+#define SWM_BARSCALE_H
+
+// Standard Libraries
+#include <stdint.h>
+
+// Slacker Headers
+#include "constants.h"
+#include "drawable.h"
+
+/// @brief One measured text width, see `BarScale__text_width`
+typedef struct BarScaleWidth BarScaleWidth;
+struct BarScaleWidth {
+	/// Hash of the text, 0 for an empty slot
+	uint64_t hash;
+	uint32_t width;
+};
+
+typedef struct BarScale BarScale;
+
+/// @brief Fonts and measurements shared by all bars drawn at one scale.
+///
+/// @details Monitors with the same scale factor share one BarScale, so the
+/// fonts are loaded and the texts are measured once per scale.
+struct BarScale {
+	/// Scale factor the fonts were loaded with, 1 is 96 DPI
+	double scale;
+	/// G_USER_FONT loaded at this scale
+	Fnt *fonts;
+	/// Height of the bar
+	int32_t bar_height;
+	/// Sum of the left and right padding around texts
+	int32_t left_right_padding_sum;
+	/// Text widths by hash, direct mapped
+	BarScaleWidth widths[TEXT_WIDTH_CACHE_SIZE];
+	/// Next loaded scale
+	BarScale *next;
+};
+
+/// @brief Looks up the fonts and measurements of a scale, loading them the
+/// first time the scale is used.
+///
+/// @details Falls back to scale 1 if the font cannot be loaded at `scale`.
+///
+/// @returns The shared BarScale, NULL if the font cannot be loaded at all
+BarScale *BarScale__get(double scale);
+
+/// @brief Width of a text drawn in the bar, with padding.
+///
+/// @details Widths are cached by the hash of the text, redraws of unchanged
+/// texts never measure again.
+uint32_t BarScale__text_width(BarScale *bar_scale, const char *text);
+
+/// @brief Frees the fonts of every loaded scale.
+void BarScale__delete_all(void);
+
+#endif
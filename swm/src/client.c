@@ -31,7 +31,7 @@ static void Client__log(Client *this)
 
 Client *Client__new(Window w_id, XWindowAttributes *wa, Monitor *monitor)
 {
-	Client *c = ecalloc(1, sizeof(Client));
+	Client *c = Pool__alloc(&g_swm.client_pool);
 	strcpy(c->name, "");
 	c->mina = 0.0;
 	c->maxa = 0.0;
@@ -43,40 +43,73 @@ Client *Client__new(Window w_id, XWindowAttributes *wa, Monitor *monitor)
 	c->bw = G_BORDER_PIXEL;
 	c->tags = 0;
 	c->isfixed = 0;
-	c->isfloating = 0;
-	c->isurgent = 0;
+	c->isfloating = false;
+	c->isurgent = false;
 	c->neverfocus = 0;
 	c->oldstate = 0;
-	c->isfullscreen = 0;
+	c->isfullscreen = false;
+	c->hidden = false;
+	c->needs_configure = true;
+	c->outline_drag = false;
+	c->attached = false;
+	c->button_grab = SlackerButtonGrab_None;
+	c->launch_stats = NULL;
+	c->launch_us = 0;
+	c->map_us = 0;
+	c->sync_counter = None;
+	c->sync_alarm = None;
+	XSyncIntToValue(&c->sync_value, 0);
+	c->sync_pending = false;
+	c->sync_sent_us = 0;
 	c->next = NULL;
 	c->stack_next = NULL;
+	c->prev = NULL;
+	c->stack_prev = NULL;
 	c->mon = monitor;
 	c->win = w_id;
 	c->log = Client__log;
 
-	if (c->x + WIDTH(c) > c->mon->wx + c->mon->ww) {
-		c->x = c->mon->wx + c->mon->ww - WIDTH(c);
-	}
+	Client__clamp_to_monitor(c);
+
+	return c;
+}
+
+void Client__clamp_to_monitor(Client *client)
+{
+	Monitor *m = client->mon;
 
-	if (c->y + HEIGHT(c) > (c->mon->wy + c->mon->wh)) {
-		c->y = c->mon->wy + c->mon->wh - HEIGHT(c);
+	if (client->x + WIDTH(client) > m->wx + m->ww) {
+		client->x = m->wx + m->ww - WIDTH(client);
 	}
 
-	c->x = MAX(c->x, c->mon->wx);
-	c->y = MAX(c->y, c->mon->wy);
+	if (client->y + HEIGHT(client) > (m->wy + m->wh)) {
+		client->y = m->wy + m->wh - HEIGHT(client);
+	}
 
-	return c;
+	client->x = MAX(client->x, m->wx);
+	client->y = MAX(client->y, m->wy);
 }
 
 void Client__delete(Client *client)
 {
 	if (client) {
+		Monitor__forget_client(client->mon, client);
 		Client__detach(client);
 		Client__detach_from_stack(client);
-		free(client);
+		Pool__free(&g_swm.client_pool, client);
 	}
 }
 
+uint32_t Client__handle(const Client *client)
+{
+	return Pool__handle(&g_swm.client_pool, client);
+}
+
+Client *Client__from_handle(uint32_t handle)
+{
+	return Pool__get(&g_swm.client_pool, handle);
+}
+
 XWindowChanges Client__update_dimensions(Client *client, int32_t x, int32_t y,
 					 int32_t w, int32_t h)
 {
@@ -120,13 +153,23 @@ bool Client__safe_to_modify(Client *client)
 
 void Client__attach(Client *client)
 {
+	client->prev = NULL;
 	client->next = client->mon->client_list;
+	if (client->next) {
+		client->next->prev = client;
+	}
 	client->mon->client_list = client;
+	client->attached = true;
+	Monitor__count_client(client->mon, client, 1);
 }
 
 void Client__attach_to_stack(Client *client)
 {
+	client->stack_prev = NULL;
 	client->stack_next = client->mon->client_stack;
+	if (client->stack_next) {
+		client->stack_next->stack_prev = client;
+	}
 	client->mon->client_stack = client;
 }
 
@@ -160,29 +203,39 @@ Client *Client__next_tiled(Client *client)
 
 void Client__detach(Client *client)
 {
-	Client **tc;
-
-	for (tc = &client->mon->client_list; *tc && *tc != client;
-	     tc = &(*tc)->next) {
-		;
+	if (client->prev) {
+		client->prev->next = client->next;
+	} else {
+		client->mon->client_list = client->next;
+	}
+	if (client->next) {
+		client->next->prev = client->prev;
 	}
-	*tc = client->next;
+	client->next = client->prev = NULL;
+	client->attached = false;
+	Monitor__count_client(client->mon, client, -1);
 }
 
 void Client__detach_from_stack(Client *client)
 {
-	Client **tc, *t;
+	Client *t = NULL;
 
-	for (tc = &client->mon->client_stack; *tc && *tc != client;
-	     tc = &(*tc)->stack_next) {
-		;
+	if (client->stack_prev) {
+		client->stack_prev->stack_next = client->stack_next;
+	} else {
+		client->mon->client_stack = client->stack_next;
 	}
-
-	*tc = client->stack_next;
+	if (client->stack_next) {
+		client->stack_next->stack_prev = client->stack_prev;
+	}
+	client->stack_next = client->stack_prev = NULL;
 
 	if (client == client->mon->selected_client) {
-		for (t = client->mon->client_stack; t && !ISVISIBLE(t);
-		     t = t->stack_next) {
+		// Nothing in view, don't walk the clients on other tags
+		t = Monitor__get_num_clients(client->mon) ?
+			    client->mon->client_stack :
+			    NULL;
+		for (; t && !ISVISIBLE(t); t = t->stack_next) {
 			;
 		}
 		client->mon->selected_client = t;
@@ -205,6 +258,39 @@ void Client__resize(Client *client, int x, int y, int w, int h, int interact)
 	client->log(client);
 }
 
+void Client__set_tags(Client *client, uint32_t tags)
+{
+	if (client->attached) {
+		Monitor__count_client(client->mon, client, -1);
+	}
+	client->tags = tags;
+	if (client->attached) {
+		Monitor__count_client(client->mon, client, 1);
+	}
+}
+
+void Client__set_floating(Client *client, int32_t isfloating)
+{
+	if (client->attached) {
+		Monitor__count_client(client->mon, client, -1);
+	}
+	client->isfloating = isfloating;
+	if (client->attached) {
+		Monitor__count_client(client->mon, client, 1);
+	}
+}
+
+void Client__set_urgent(Client *client, int32_t isurgent)
+{
+	if (client->attached) {
+		Monitor__count_client(client->mon, client, -1);
+	}
+	client->isurgent = isurgent;
+	if (client->attached) {
+		Monitor__count_client(client->mon, client, 1);
+	}
+}
+
 void Client__send_to_monitor(Client *client, Monitor *target_monitor)
 {
 	// If the clients currently registered monitor is the same as the target monitor, return.
@@ -216,6 +302,7 @@ void Client__send_to_monitor(Client *client, Monitor *target_monitor)
 	Swm__unfocus(client, 1);
 	Client__detach(client);
 	Client__detach_from_stack(client);
+	Monitor__forget_client(client->mon, client);
 	// Update the clients monitor with the new monitor it will be on.
 	client->mon = target_monitor;
 	// Assign tags of target monitor
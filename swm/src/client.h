@@ -4,11 +4,13 @@
 // X11
 #include <X11/Xlib.h>
 #include <X11/X.h>
+#include <X11/extensions/sync.h>
 
 // Standard Libraries
 #include <bits/stdint-intn.h>
 #include <bits/stdint-uintn.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 // Slacker headers
 #include "constants.h"
@@ -23,26 +25,78 @@ typedef struct Client Client;
 /// @brief Callback function type for Client debugging information
 typedef void (*ClientLogFunction)(Client *);
 
+/// @details The fields every list scan reads come first and fill one cache
+/// line, see `ClientCompileTimeCheck`. Names, size hints and sync state
+/// are only touched for a single client and come after them.
 struct Client {
-	char name[MAX_CLIENT_NAME_LEN];
-	float mina, maxa;
+	// Hot, read by ISVISIBLE, `Client__next_tiled`, `Swm__showhide`,
+	// `Monitor__prepare_hidden_tags`, the view recount of
+	// `Monitor__get_num_clients` and the `Swm__focus` fallback
+	Client *next;
+	Client *stack_next;
+	Monitor *mon;
+	Window win;
+	uint32_t tags;
+	bool isfloating;
+	bool isurgent;
+	bool isfullscreen;
+	/// The window is parked off screen, see `Swm__showhide`
+	bool hidden;
 	int32_t x, y, w, h;
-	int32_t oldx, oldy, oldw, oldh;
-	int32_t basew, baseh, incw, inch, maxw, maxh, minw, minh, hintsvalid;
+
 	/// border width, old border width
 	int32_t bw, oldbw;
-	uint32_t tags;
+	/// Managed but no ConfigureWindow sent yet, see `Swm__manage_client`
+	bool needs_configure;
+	/// Mouse drags only draw an outline, set by the window rule
+	bool outline_drag;
+	/// In the client list of its monitor and counted in the per tag
+	/// counts there, see `Monitor__count_client`
+	bool attached;
+	/// Previous client in the client list and in the stack, NULL at the
+	/// head. Only read to unlink a client, so kept out of the hot fields.
+	Client *prev;
+	Client *stack_prev;
 	int32_t isfixed;
-	int32_t isfloating;
-	int32_t isurgent;
 	int32_t neverfocus;
 	int32_t oldstate;
-	int32_t isfullscreen;
-	Client *next;
-	Client *stack_next;
-	Monitor *mon;
-	Window win;
+	/// SlackerButtonGrab, the buttons grabbed on the window
+	uint32_t button_grab;
+	int32_t oldx, oldy, oldw, oldh;
+	float mina, maxa;
+	int32_t basew, baseh, incw, inch, maxw, maxh, minw, minh, hintsvalid;
+	/// _NET_WM_SYNC_REQUEST counter, None if the client does not support it
+	XSyncCounter sync_counter;
+	/// Alarm which reports when the client reached sync_value
+	XSyncAlarm sync_alarm;
+	/// Counter value of the last sync request
+	XSyncValue sync_value;
+	/// A sync request was sent and not acknowledged yet
+	bool sync_pending;
+	/// Monotonic time in microseconds of the last sync request
+	uint64_t sync_sent_us;
+	/// Launch statistics until the first expose, NULL if the window
+	/// wasn't matched to a spawn, see launch.h
+	struct LaunchStats *launch_stats;
+	/// Monotonic time in microseconds of the spawn and of the map
+	uint64_t launch_us, map_us;
 	ClientLogFunction log;
+	/// Hash of name, a title rewritten to the same text changes nothing
+	uint64_t name_hash;
+	char name[MAX_CLIENT_NAME_LEN];
+};
+
+/// @brief Compile time check that the hot fields of a client share one
+/// cache line
+struct ClientCompileTimeCheck {
+	uint32_t hotfieldsfit[offsetof(Client, h) + sizeof(int32_t) <=
+					      CACHE_LINE_SIZE ?
+				      1 :
+				      -1];
+	uint32_t hiddenfits[offsetof(Client, hidden) + sizeof(bool) <=
+					    CACHE_LINE_SIZE ?
+				    1 :
+				    -1];
 };
 
 /// @brief Builds a new client
@@ -52,6 +106,22 @@ struct Client {
 /// @param `monitor` The monitor the client is being created on
 Client *Client__new(Window w_id, XWindowAttributes *wa, Monitor *monitor);
 
+/// @brief A reference to the client which can be kept across events.
+///
+/// @returns The handle, see pool.h
+uint32_t Client__handle(const Client *client);
+
+/// @brief Looks up a client by its handle.
+///
+/// @returns The client, NULL if it was unmanaged since
+Client *Client__from_handle(uint32_t handle);
+
+/// @brief Moves the client's geometry inside the work area of its monitor.
+///
+/// @details Called again when the monitor changes before the window is
+/// mapped, e.g by a window rule or the monitor it was spawned from.
+void Client__clamp_to_monitor(Client *client);
+
 /// @brief Detatches a client from the monitor stack list and the monitor linked list.
 ///
 /// @param `client` The client to add to the monitor's client list.
@@ -88,9 +158,13 @@ void Client__configure(Display *xconn, Client *client);
 Client *Client__next_tiled(Client *client);
 
 /// @brief Detaches a client from a monitor's client list.
+///
+/// @details Constant time, the list is doubly linked through `prev`.
 void Client__detach(Client *client);
 
 /// @brief Detaches a client from a monitor's stack list.
+///
+/// @details Constant time, the stack is doubly linked through `stack_prev`.
 void Client__detach_from_stack(Client *client);
 
 /// @brief Removes a client from the client list.
@@ -99,6 +173,19 @@ void Client__pop(Client *client);
 /// @brief Applies size hints to a given client.
 void Client__resize(Client *client, int x, int y, int w, int h, int interact);
 
+/// @brief Moves a client to other tags, keeping the counts of its monitor.
+void Client__set_tags(Client *client, uint32_t tags);
+
+/// @brief Changes the floating state of a client, keeping the counts of its
+/// monitor.
+void Client__set_floating(Client *client, int32_t isfloating);
+
+/// @brief Changes the urgent state of a client, keeping the counts of its
+/// monitor.
+///
+/// @details Only the state swm keeps, see `Swm__seturgent` for the hint.
+void Client__set_urgent(Client *client, int32_t isurgent);
+
 /// @brief Sends a client to a differnt monitor.
 ///
 /// @param `client` The client to send to a different monitor
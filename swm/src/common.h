@@ -37,6 +37,9 @@ enum SlackerEWMHAtom {
 	SlackerEWMHAtom_NetWMWindowType,
 	SlackerEWMHAtom_NetWMWindowTypeDialog,
 	SlackerEWMHAtom_NetClientList,
+	SlackerEWMHAtom_NetWMSyncRequest,
+	SlackerEWMHAtom_NetWMSyncRequestCounter,
+	SlackerEWMHAtom_NetWMPid,
 	SlackerEWMHAtom_NetLast
 };
 
@@ -46,6 +49,8 @@ enum SlackerDefaultAtom {
 	SlackerDefaultAtom_WMDelete,
 	SlackerDefaultAtom_WMState,
 	SlackerDefaultAtom_WMTakeFocus,
+	SlackerDefaultAtom_SwmLaunchStats,
+	SlackerDefaultAtom_Utf8String,
 	SlackerDefaultAtom_WMLast
 };
 
@@ -60,6 +65,26 @@ enum SlackerClick {
 	SlackerClick_Last
 };
 
+// Mouse drags, passed as Arg.i to the move and resize bindings
+enum SlackerDrag {
+	SlackerDrag_Live,
+	SlackerDrag_Outline,
+};
+
+// Button grabs on a client window, see `Swm__grab_buttons`
+enum SlackerButtonGrab {
+	SlackerButtonGrab_None,
+	SlackerButtonGrab_Focused,
+	SlackerButtonGrab_Unfocused,
+};
+
+// Kind of the mouse drag in progress, see drag.h
+enum SlackerDragKind {
+	SlackerDragKind_None,
+	SlackerDragKind_Move,
+	SlackerDragKind_Resize,
+};
+
 //////////////////////////
 /// Data Structures
 //////////////////////////
@@ -73,6 +98,8 @@ struct SlackerWindowRule {
 	uint32_t tags;
 	int32_t isfloating;
 	int32_t monitor;
+	/// Move and resize the window as an outline, see `SlackerDrag_Outline`
+	int32_t outline_drag;
 };
 
 /// @brief Represents an argument to a function
@@ -35,11 +35,11 @@ const char *G_COLORSCHEMES[MAX_COLOR_SCHEMES][MAX_COLOR_VARIANTS] = {
 
 
 const SlackerWindowRule G_WINDOW_RULES[] = {
-    // ================================================================================================
-    // | Class Name   Instance        Title           Tags            Mask     isfloating   monitor   |
-    // ================================================================================================
-    { "Gimp",        NULL,          NULL,           0,              1,      -1 },
-    { "Firefox",     NULL,          NULL,           (1 << 8),       0,      -1 },
+    // ===========================================================================================================
+    // | Class Name   Instance        Title           Tags            Mask     isfloating   monitor   outline    |
+    // ===========================================================================================================
+    { "Gimp",        NULL,          NULL,           0,              1,      -1,          0 },
+    { "Firefox",     NULL,          NULL,           (1 << 8),       0,      -1,          0 },
 };
 
 const Layout G_LAYOUTS[] = {
@@ -101,6 +101,8 @@ const Button G_CLICKABLE_BUTTONS[MAX_BUTTON_BINDINGS] = {
     { SlackerClick_ClientWin,          MODKEY,         Button1,        Swm__move_with_mouse,            {0}                         },
     { SlackerClick_ClientWin,          MODKEY,         Button2,        Swm__togglefloating,             {0}                         },
     { SlackerClick_ClientWin,          MODKEY,         Button3,        Swm__resize_client_with_mouse,   {0}                         },
+    { SlackerClick_ClientWin,          MODKEY|ShiftMask, Button1,      Swm__move_with_mouse,            {.i = SlackerDrag_Outline}  },
+    { SlackerClick_ClientWin,          MODKEY|ShiftMask, Button3,      Swm__resize_client_with_mouse,   {.i = SlackerDrag_Outline}  },
     { SlackerClick_TagBar,             0,              Button1,        Swm__view,                       {0}                         },
     { SlackerClick_TagBar,             0,              Button3,        Swm__toggleview,                 {0}                         },
     { SlackerClick_TagBar,             MODKEY,         Button1,        Swm__tag,                        {0}                         },
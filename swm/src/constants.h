@@ -11,8 +11,28 @@
 #define MAX_WINDOW_RULES 20
 #define MAX_LAYOUTS 3
 #define MAX_KEY_BINDINGS 100
+#define MAX_KEYCODES 256
+#define MAX_CLEAN_MASKS 256
 #define MAX_BUTTON_BINDINGS 20
 #define MAX_LAYOUT_SYMBOL_LEN 16
 #define MAX_AUTOSTART_COMMANDS 64
+#define AUTOSTART_BACKOFF_MIN_MS 500
+#define AUTOSTART_BACKOFF_MAX_MS 30000
+#define AUTOSTART_STABLE_MS 10000
+#define SYNC_REQUEST_TIMEOUT_MS 100
+#define DEFAULT_REFRESH_RATE 60
+#define MONITOR_SETTLE_MS 150
+#define MAX_BAR_SCALE 4
+#define TEXT_WIDTH_CACHE_SIZE 64
+#define MAX_FONT_NAME_LEN 256
+#define MAX_PENDING_LAUNCHES 32
+#define MAX_LAUNCH_COMMANDS 16
+#define LAUNCH_SAMPLES 64
+#define LAUNCH_TIMEOUT_MS 30000
+#define LAUNCH_MAX_DEPTH 8
+#define MAX_LAUNCH_STATS_LEN 4096
+#define POOL_SLAB_ITEMS 64
+#define POOL_INDEX_BITS 16
+#define CACHE_LINE_SIZE 64
 
 #endif // SLACKER_CONSTANTS_H
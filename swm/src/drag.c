@@ -0,0 +1,339 @@
+// X11 Libraries
+#include <X11/Xlib.h>
+#include <X11/extensions/sync.h>
+
+// Standard Libraries
+#include <stdlib.h>
+
+// Slacker Headers
+#include "common.h"
+#include "config.h"
+#include "drag.h"
+#include "randr.h"
+#include "swm.h"
+#include "utils.h"
+
+/// @brief The client being dragged, NULL if it is gone.
+static Client *Drag__client(const Drag *drag)
+{
+	return Client__from_handle(drag->client);
+}
+
+/// @brief Replaces a motion event with the newest one queued right behind it,
+/// so a drag never steps through stale pointer positions.
+static void Drag__newest_motion(XEvent *event)
+{
+	XEvent next;
+
+	while (XEventsQueued(g_swm.ctx.xconn, QueuedAfterReading)) {
+		XPeekEvent(g_swm.ctx.xconn, &next);
+		if (next.type != MotionNotify) {
+			break;
+		}
+		XNextEvent(g_swm.ctx.xconn, event);
+	}
+}
+
+/// @brief Draws the outline at the current geometry, drawing it a second
+/// time erases it.
+static void Drag__toggle_outline(Drag *drag)
+{
+	XDrawRectangle(g_swm.ctx.xconn, g_swm.ctx.xroot_id, drag->outline_gc,
+		       drag->nx, drag->ny, drag->nw + 2 * drag->bw - 1,
+		       drag->nh + 2 * drag->bw - 1);
+	drag->outline_shown = !drag->outline_shown;
+}
+
+/// @brief Creates the GC for outline drags, drawing by inverting the root.
+static GC Drag__outline_gc(void)
+{
+	XGCValues gcv = {
+		.function = GXxor,
+		.subwindow_mode = IncludeInferiors,
+		.line_width = G_BORDER_PIXEL,
+		.foreground = WhitePixel(g_swm.ctx.xconn, g_swm.ctx.xscreen_id) ^
+			      BlackPixel(g_swm.ctx.xconn, g_swm.ctx.xscreen_id),
+	};
+
+	return XCreateGC(g_swm.ctx.xconn, g_swm.ctx.xroot_id,
+			 GCFunction | GCSubwindowMode | GCLineWidth |
+				 GCForeground,
+			 &gcv);
+}
+
+/// @brief Computes the geometry the newest pointer position asks for.
+///
+/// @details Moves snap to the edges of the monitor of the client.
+static void Drag__target(Drag *drag)
+{
+	const Client *client = Drag__client(drag);
+	const Monitor *sm = client->mon;
+	const XMotionEvent *motion = &drag->motion;
+
+	if (drag->kind == SlackerDragKind_Resize) {
+		drag->nw = MAX((motion->x - drag->ocx - 2 * client->bw + 1), 1);
+		drag->nh = MAX((motion->y - drag->ocy - 2 * client->bw + 1), 1);
+		return;
+	}
+
+	drag->nx = drag->ocx + (motion->x - drag->x);
+	drag->ny = drag->ocy + (motion->y - drag->y);
+
+	if (abs(sm->wx - drag->nx) < G_SNAP_PIXEL) {
+		drag->nx = sm->wx;
+	} else if (((sm->wx + sm->ww) - (drag->nx + WIDTH(client))) <
+		   G_SNAP_PIXEL) {
+		drag->nx = sm->wx + sm->ww - WIDTH(client);
+	}
+
+	if (abs(sm->wy - drag->ny) < G_SNAP_PIXEL) {
+		drag->ny = sm->wy;
+	} else if (((sm->wy + sm->wh) - (drag->ny + HEIGHT(client))) <
+		   G_SNAP_PIXEL) {
+		drag->ny = sm->wy + sm->wh - HEIGHT(client);
+	}
+}
+
+/// @brief Gives the client the geometry the drag asks for, making a tiled
+/// client floating once it is dragged further than the snap distance.
+static void Drag__apply(Drag *drag)
+{
+	Client *client = Drag__client(drag);
+	Monitor *sm = client->mon;
+	bool float_it = false;
+	bool tiled = !client->isfloating &&
+		     sm->layouts[sm->selected_layout]->handler;
+	int x = 0;
+	int y = 0;
+	int w = 0;
+	int h = 0;
+
+	if (drag->kind == SlackerDragKind_Resize) {
+		if (tiled && client->mon->wx + drag->nw >= sm->wx &&
+		    client->mon->wx + drag->nw <= sm->wx + sm->ww &&
+		    client->mon->wy + drag->nh >= sm->wy &&
+		    client->mon->wy + drag->nh <= sm->wy + sm->wh &&
+		    (abs(drag->nw - client->w) > G_SNAP_PIXEL ||
+		     abs(drag->nh - client->h) > G_SNAP_PIXEL)) {
+			float_it = true;
+		}
+	} else if (tiled && (abs(drag->nx - client->x) > G_SNAP_PIXEL ||
+			     abs(drag->ny - client->y) > G_SNAP_PIXEL)) {
+		float_it = true;
+	}
+
+	// The selection may have moved on since the drag started, so this
+	// can't go through `Swm__togglefloating`
+	if (float_it) {
+		Client__set_floating(client, 1);
+		Swm__arrange_monitors(sm);
+	}
+
+	if (!sm->layouts[sm->selected_layout]->handler || client->isfloating) {
+		if (drag->kind == SlackerDragKind_Resize) {
+			x = client->x;
+			y = client->y;
+			w = drag->nw;
+			h = drag->nh;
+			if (!Swm__applysizehints(client, &x, &y, &w, &h, 1)) {
+				return;
+			}
+			// Only a live resize waits for the client, see
+			// `Drag__motion`. The request has to go out before the
+			// configure it announces.
+			if (!drag->outline) {
+				Swm__sync_request(client);
+			}
+			Swm__resize_client(client, x, y, w, h);
+		} else {
+			Client__resize(client, drag->nx, drag->ny, client->w,
+				       client->h, 1);
+		}
+	}
+}
+
+/// @brief Follows the newest pointer position, with the outline or the client.
+static void Drag__update(Drag *drag)
+{
+	uint64_t now_us = Timing__now_us();
+
+	drag->lasttime = drag->motion.time;
+	drag->motion_pending = false;
+
+	if (drag->outline_shown) {
+		Drag__toggle_outline(drag);
+	}
+	Drag__target(drag);
+	if (drag->outline) {
+		Drag__toggle_outline(drag);
+	} else {
+		Drag__apply(drag);
+	}
+
+	if (drag->frame_us) {
+		TimingStats__record(&drag->frames, now_us - drag->frame_us);
+	}
+	drag->frame_us = now_us;
+}
+
+/// @brief Releases the server and pointer grabs and forgets the drag.
+static void Drag__release(Drag *drag)
+{
+	if (drag->outline) {
+		if (drag->outline_shown) {
+			Drag__toggle_outline(drag);
+		}
+		Swm__ungrab_server();
+		XFreeGC(g_swm.ctx.xconn, drag->outline_gc);
+	}
+
+	XUngrabPointer(g_swm.ctx.xconn, CurrentTime);
+	drag->kind = SlackerDragKind_None;
+	drag->client = 0;
+}
+
+void Drag__begin(uint32_t kind, Client *client, bool outline, int32_t x,
+		 int32_t y)
+{
+	Drag *drag = &g_swm.drag;
+
+	*drag = (Drag){
+		.kind = kind,
+		.client = Client__handle(client),
+		.bw = client->bw,
+		.outline = outline,
+		.ocx = client->x,
+		.ocy = client->y,
+		.x = x,
+		.y = y,
+		.nx = client->x,
+		.ny = client->y,
+		.nw = client->w,
+		.nh = client->h,
+		// Update at most once per frame of the monitor under the
+		// pointer
+		.frame_ms = 1000.0 / Randr__refresh_rate_at(x, y),
+		.frames = { kind == SlackerDragKind_Resize ?
+				    "resize drag frame time" :
+				    "move drag frame time" },
+	};
+
+	// The outline is drawn over the other windows, keep them from
+	// painting underneath it until the drag is over.
+	if (outline) {
+		drag->outline_gc = Drag__outline_gc();
+		Swm__grab_server();
+		Drag__toggle_outline(drag);
+	}
+}
+
+void Drag__motion(XEvent *event)
+{
+	Drag *drag = &g_swm.drag;
+	Client *client = Drag__client(drag);
+	bool paced = false;
+
+	if (!client) {
+		Drag__release(drag);
+		return;
+	}
+
+	Drag__newest_motion(event);
+	drag->motion = event->xmotion;
+	drag->motion_pending = true;
+
+	// Live resizes of clients with _NET_WM_SYNC_REQUEST pace themselves,
+	// everything else gets one update per frame of the monitor.
+	paced = drag->kind == SlackerDragKind_Resize && !drag->outline &&
+		client->sync_counter;
+	if (!paced && (drag->motion.time - drag->lasttime) < drag->frame_ms) {
+		return;
+	}
+	if (paced && Swm__sync_waiting(client)) {
+		return;
+	}
+
+	Drag__update(drag);
+}
+
+void Drag__sync_alarm(XEvent *event)
+{
+	Drag *drag = &g_swm.drag;
+	Client *client = Drag__client(drag);
+
+	// The client caught up, hand it the newest size
+	if (client && drag->kind == SlackerDragKind_Resize && !drag->outline &&
+	    Swm__sync_acknowledged(client, event) &&
+	    drag->motion_pending) {
+		Drag__update(drag);
+	}
+}
+
+void Drag__end(void)
+{
+	Drag *drag = &g_swm.drag;
+	Client *client = Drag__client(drag);
+	Monitor *temp_monitor = NULL;
+
+	if (!client) {
+		Drag__release(drag);
+		return;
+	}
+
+	if (drag->outline_shown) {
+		Drag__toggle_outline(drag);
+	}
+
+	// Never drop the geometry the drag ended with, outline drags
+	// configure the client only here.
+	if (drag->motion_pending) {
+		Drag__target(drag);
+	}
+	if (drag->motion_pending || drag->outline) {
+		Drag__apply(drag);
+	}
+	TimingStats__log(&drag->frames);
+
+	if (drag->kind == SlackerDragKind_Resize) {
+		XWarpPointer(g_swm.ctx.xconn, None, client->win, 0, 0, 0, 0,
+			     client->w + (client->bw - 1),
+			     client->h + (client->bw - 1));
+	}
+	Drag__release(drag);
+	Swm__ignore_enter_events();
+
+	if ((temp_monitor = Swm__rect_to_monitor(client->x, client->y,
+						 client->w, client->h)) !=
+	    client->mon) {
+		Client__send_to_monitor(client, temp_monitor);
+		g_swm.selected_monitor = temp_monitor;
+		Swm__focus(NULL);
+	}
+}
+
+void Drag__cancel(Client *client)
+{
+	if (g_swm.drag.kind != SlackerDragKind_None &&
+	    g_swm.drag.client == Client__handle(client)) {
+		Drag__release(&g_swm.drag);
+	}
+}
+
+bool Drag__suspend_outline(const XEvent *event)
+{
+	if (!g_swm.drag.outline_shown || event->type == MotionNotify ||
+	    event->type == ButtonPress || event->type == ButtonRelease) {
+		return false;
+	}
+
+	Drag__toggle_outline(&g_swm.drag);
+	return true;
+}
+
+void Drag__resume_outline(void)
+{
+	if (g_swm.drag.kind != SlackerDragKind_None && g_swm.drag.outline &&
+	    !g_swm.drag.outline_shown) {
+		Drag__toggle_outline(&g_swm.drag);
+	}
+}
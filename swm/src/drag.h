@@ -0,0 +1,88 @@
+#ifndef SWM_DRAG_H
+#define SWM_DRAG_H
+
+/// Mouse move and resize as a state of the main event loop.
+///
+/// A drag is started by a button binding and then fed the pointer and sync
+/// events by the main loop, everything else keeps being handled as usual
+/// while the button is held.
+
+// X11 Libraries
+#include <X11/Xlib.h>
+
+// Standard Libraries
+#include <stdbool.h>
+#include <stdint.h>
+
+// Slacker Headers
+#include "client.h"
+#include "timing.h"
+
+typedef struct Drag Drag;
+
+/// @brief A mouse move or resize in progress, lives in `g_swm.drag`.
+struct Drag {
+	/// SlackerDragKind, SlackerDragKind_None while no drag is active
+	uint32_t kind;
+	/// Handle of the client being dragged, see `Client__handle`
+	uint32_t client;
+	/// Border width of the client, for the outline
+	int32_t bw;
+	/// Only an outline is drawn until the button is released
+	bool outline;
+	/// The outline is currently drawn on the root window
+	bool outline_shown;
+	/// GC drawing the outline
+	GC outline_gc;
+	/// Position of the client when the drag started
+	int32_t ocx, ocy;
+	/// Position of the pointer when the drag started
+	int32_t x, y;
+	/// Geometry the drag currently asks for
+	int32_t nx, ny, nw, nh;
+	/// Minimum time between two updates, one frame of the monitor
+	double frame_ms;
+	/// Server time of the last applied pointer position
+	Time lasttime;
+	/// Newest pointer position, not applied yet if motion_pending
+	XMotionEvent motion;
+	bool motion_pending;
+	/// Time between two updates
+	TimingStats frames;
+	/// Monotonic time in microseconds of the last update
+	uint64_t frame_us;
+};
+
+/// @brief Starts a drag, the pointer must already be grabbed.
+///
+/// @param `kind` SlackerDragKind_Move or SlackerDragKind_Resize
+/// @param `client` The client to drag
+/// @param `outline` Draw an outline and configure the client on release only
+/// @param `x` `y` Root position of the pointer
+void Drag__begin(uint32_t kind, Client *client, bool outline, int32_t x,
+		 int32_t y);
+
+/// @brief Follows the pointer, called for MotionNotify while dragging.
+void Drag__motion(XEvent *event);
+
+/// @brief Hands a resized client the newest size once it painted the last one.
+void Drag__sync_alarm(XEvent *event);
+
+/// @brief Applies the final geometry and releases the pointer, called on
+/// ButtonRelease.
+void Drag__end(void);
+
+/// @brief Aborts the drag without touching the client, if it drags `client`.
+///
+/// @details Called before a client is unmanaged.
+void Drag__cancel(Client *client);
+
+/// @brief Takes the outline off the screen before an event which may paint.
+///
+/// @returns true if the outline has to be restored with `Drag__resume_outline`
+bool Drag__suspend_outline(const XEvent *event);
+
+/// @brief Draws the outline again after `Drag__suspend_outline`.
+void Drag__resume_outline(void);
+
+#endif
@@ -9,8 +9,11 @@
 // Swm headers
 #include "common.h"
 #include "config.h"
+#include "drag.h"
 #include "events.h"
+#include "randr.h"
 #include "swm.h"
+#include "timing.h"
 #include "utils.h"
 
 void Swm__event_loop(XEvent *event)
@@ -19,6 +22,9 @@ void Swm__event_loop(XEvent *event)
 	case ButtonPress:
 		Swm__event_button_press(event);
 		break;
+	case ButtonRelease:
+		Swm__event_button_release(event);
+		break;
 	case ClientMessage:
 		Swm__event_client_message(event);
 		break;
@@ -59,6 +65,14 @@ void Swm__event_loop(XEvent *event)
 		Swm__event_unmap_notify(event);
 		break;
 	default:
+		if (Randr__handle_event(event)) {
+			break;
+		}
+		if (g_swm.has_sync &&
+		    event->type == g_swm.sync_event_base + XSyncAlarmNotify) {
+			Swm__event_sync_alarm(event);
+			break;
+		}
 		// if (DEBUG == 1) {
 		// 	fprintf(stdout, "Unhandled event: %d\n", event->type);
 		// }
@@ -66,48 +80,76 @@ void Swm__event_loop(XEvent *event)
 	}
 }
 
+/// @brief Time until a click on an unfocused client is replayed to it, and
+/// until its focus and stacking requests are sent.
+static TimingStats s_click_replay_stats = { "click replay" };
+static TimingStats s_click_focus_stats = { "click focus" };
+
 void Swm__event_button_press(XEvent *event)
 {
+	uint64_t start_us = Timing__now_us();
 	uint32_t i = 0;
 	uint32_t x = 0;
 	uint32_t click = SlackerClick_RootWin;
 	Arg arg = { 0 };
 	Client *temp_client = NULL;
 	Monitor *temp_monitor = NULL;
+	Monitor *sm = NULL;
 	XButtonPressedEvent *ev = &event->xbutton;
 
+	// Other buttons do nothing until the drag is over
+	if (g_swm.drag.kind != SlackerDragKind_None) {
+		return;
+	}
+
+	// Hand a client its click before anything else, the focus and
+	// stacking changes below are sent without waiting for the server.
+	if ((temp_client = Swm__win_to_client(ev->window))) {
+		XAllowEvents(g_swm.ctx.xconn, ReplayPointer, CurrentTime);
+		XFlush(g_swm.ctx.xconn);
+		TimingStats__record(&s_click_replay_stats,
+				    Timing__now_us() - start_us);
+		temp_monitor = temp_client->mon;
+	} else {
+		temp_monitor = Swm__wintomon(ev->window);
+	}
+
 	// Focus monitor if necessary
-	if ((temp_monitor = Swm__wintomon(ev->window)) &&
-	    temp_monitor != g_swm.selected_monitor) {
+	if (temp_monitor && temp_monitor != g_swm.selected_monitor) {
 		Swm__unfocus(g_swm.selected_monitor->selected_client, 1);
 		g_swm.selected_monitor = temp_monitor;
-		Swm__focus(NULL);
+		if (!temp_client) {
+			Swm__focus(NULL);
+		}
 	}
 
 	// Check if the button press was a click on the bar
-	if (ev->window == g_swm.selected_monitor->bar_win_id) {
+	if (ev->window == (sm = g_swm.selected_monitor)->bar_win_id) {
 		do {
-			x += TEXTW(G_TAGS[i]);
+			x += TEXTW(sm, G_TAGS[i]);
 		} while (ev->x >= x && ++i < LENGTH(G_TAGS));
 
 		if (i < LENGTH(G_TAGS)) {
 			click = SlackerClick_TagBar;
 			arg.ui = 1 << i;
-		} else if (ev->x <
-			   x + TEXTW(g_swm.selected_monitor->layout_symbol)) {
+		} else if (ev->x < x + TEXTW(sm, sm->layout_symbol)) {
 			click = SlackerClick_LtSymbol;
-		} else if (ev->x > g_swm.selected_monitor->ww -
-					   (int)TEXTW(g_swm.status_text)) {
+		} else if (ev->x >
+			   sm->ww - (int)TEXTW(sm, g_swm.status_text)) {
 			click = SlackerClick_StatusText;
 		} else {
 			click = SlackerClick_WinTitle;
 		}
 	}
 
-	if ((temp_client = Swm__win_to_client(ev->window))) {
+	if (temp_client) {
 		Swm__focus(temp_client);
 		Swm__restack(g_swm.selected_monitor);
-		XAllowEvents(g_swm.ctx.xconn, ReplayPointer, CurrentTime);
+		XFlush(g_swm.ctx.xconn);
+		TimingStats__record(&s_click_focus_stats,
+				    Timing__now_us() - start_us);
+		TimingStats__log(&s_click_replay_stats);
+		TimingStats__log(&s_click_focus_stats);
 		click = SlackerClick_ClientWin;
 	}
 
@@ -130,6 +172,20 @@ void Swm__event_button_press(XEvent *event)
 	}
 }
 
+void Swm__event_button_release(XEvent *event)
+{
+	if (g_swm.drag.kind != SlackerDragKind_None) {
+		Drag__end();
+	}
+}
+
+void Swm__event_sync_alarm(XEvent *event)
+{
+	if (g_swm.drag.kind != SlackerDragKind_None) {
+		Drag__sync_alarm(event);
+	}
+}
+
 void Swm__event_client_message(XEvent *event)
 {
 	XClientMessageEvent *cme = &event->xclient;
@@ -249,42 +305,13 @@ void Swm__event_configure_request(XEvent *event)
 
 void Swm__event_configure_notify(XEvent *event)
 {
-	Monitor *temp_monitor = NULL;
-	Client *temp_client = NULL;
 	XConfigureEvent *ev = &event->xconfigure;
 
+	// Outputs change in bursts, the monitors are updated once they settle
 	if (ev->window == g_swm.ctx.xroot_id) {
-		int32_t dirty = (g_swm.ctx.xscreen_width != ev->width ||
-				 g_swm.ctx.xscreen_height != ev->height);
 		g_swm.ctx.xscreen_width = ev->width;
 		g_swm.ctx.xscreen_height = ev->height;
-		if (Swm__updategeom() || dirty) {
-			drw_resize(g_swm.draw, g_swm.ctx.xscreen_width,
-				   g_swm.bar_height);
-			Swm__updatebars();
-			for (temp_monitor = g_swm.monitor_list; temp_monitor;
-			     temp_monitor = temp_monitor->next) {
-				for (temp_client = temp_monitor->client_list;
-				     temp_client;
-				     temp_client = temp_client->next) {
-					if (temp_client->isfullscreen)
-						Swm__resize_client(
-							temp_client,
-							temp_monitor->mx,
-							temp_monitor->my,
-							temp_monitor->mw,
-							temp_monitor->mh);
-				}
-				XMoveResizeWindow(g_swm.ctx.xconn,
-						  temp_monitor->bar_win_id,
-						  temp_monitor->wx,
-						  temp_monitor->bar_y,
-						  temp_monitor->ww,
-						  g_swm.bar_height);
-			}
-			Swm__focus(NULL);
-			Swm__arrange_monitors(NULL);
-		}
+		Swm__schedule_monitor_update();
 	}
 }
 
@@ -309,6 +336,11 @@ void Swm__event_enter_notify(XEvent *event)
 		return;
 	}
 
+	// Caused by restacking, not by the pointer moving
+	if ((long)(ev->serial - g_swm.enter_ignore_serial) < 0) {
+		return;
+	}
+
 	temp_client = Swm__win_to_client(ev->window);
 	temp_monitor = temp_client ? temp_client->mon :
 				     Swm__wintomon(ev->window);
@@ -326,10 +358,22 @@ void Swm__event_enter_notify(XEvent *event)
 void Swm__event_expose(XEvent *event)
 {
 	Monitor *monitor;
+	Client *client;
 	XExposeEvent *ev = &event->xexpose;
 
-	if (ev->count == 0 && (monitor = Swm__wintomon(ev->window))) {
-		Swm__drawbar(monitor);
+	for (monitor = g_swm.monitor_list; monitor; monitor = monitor->next) {
+		if (ev->window == monitor->bar_win_id) {
+			if (ev->count == 0) {
+				Swm__drawbar(monitor);
+			}
+			return;
+		}
+	}
+
+	// Only selected on clients until their first expose, see launch.h
+	if (g_swm.launches.awaiting_expose &&
+	    (client = Swm__win_to_client(ev->window))) {
+		Launch__exposed(client);
 	}
 }
 
@@ -346,15 +390,15 @@ void Swm__event_focusin(XEvent *event)
 void Swm__event_keypress(XEvent *event)
 {
 	XKeyEvent *ev = &event->xkey;
-	KeySym keysym =
-		XkbKeycodeToKeysym(g_swm.ctx.xconn, (KeyCode)ev->keycode, 0, 0);
-
-	for (uint32_t i = 0; i < LENGTH(G_KEYBINDINGS); ++i) {
-		if (keysym == G_KEYBINDINGS[i].keysym &&
-		    CLEANMASK(G_KEYBINDINGS[i].mod) == CLEANMASK(ev->state) &&
-		    G_KEYBINDINGS[i].handler) {
-			G_KEYBINDINGS[i].handler(&(G_KEYBINDINGS[i].arg));
-		}
+	uint8_t binding = 0;
+
+	// The bindings of this key and modifiers were looked up when the keys
+	// were grabbed, see `Swm__grab_keys`
+	for (binding = g_swm.key_dispatch[ev->keycode & (MAX_KEYCODES - 1)]
+					 [CLEANMASK(ev->state)];
+	     binding; binding = g_swm.key_dispatch_next[binding - 1]) {
+		G_KEYBINDINGS[binding - 1].handler(
+			&(G_KEYBINDINGS[binding - 1].arg));
 	}
 }
 
@@ -363,7 +407,11 @@ void Swm__event_mapping_notify(XEvent *event)
 	XMappingEvent *ev = &event->xmapping;
 
 	XRefreshKeyboardMapping(ev);
-	if (ev->request == MappingKeyboard) {
+	if (ev->request == MappingKeyboard || ev->request == MappingModifier) {
+		// The buttons are grabbed with the numlock mask as well
+		if (Swm__update_numlock_mask()) {
+			Swm__regrab_buttons();
+		}
 		Swm__grab_keys();
 	}
 }
@@ -385,21 +433,11 @@ void Swm__event_map_request(XEvent *event)
 
 void Swm__event_motion_notify(XEvent *event)
 {
-	static Monitor *s_mon = NULL;
-	Monitor *temp_mon = NULL;
-	XMotionEvent *ev = &event->xmotion;
-
-	if (ev->window != g_swm.ctx.xroot_id) {
-		return;
-	}
-	if ((temp_mon = Swm__rect_to_monitor(ev->x_root, ev->y_root, 1, 1)) !=
-		    s_mon &&
-	    s_mon) {
-		Swm__unfocus(g_swm.selected_monitor->selected_client, 1);
-		g_swm.selected_monitor = temp_mon;
-		Swm__focus(NULL);
+	// The root only reports motion while a drag grabs the pointer,
+	// monitor crossings come from the backdrop windows instead.
+	if (g_swm.drag.kind != SlackerDragKind_None) {
+		Drag__motion(event);
 	}
-	s_mon = temp_mon;
 }
 
 void Swm__event_property_notify(XEvent *event)
@@ -419,8 +457,8 @@ void Swm__event_property_notify(XEvent *event)
 			if (!client->isfloating &&
 			    (XGetTransientForHint(g_swm.ctx.xconn, client->win,
 						  &trans)) &&
-			    (client->isfloating = (Swm__win_to_client(trans)) !=
-						  NULL)) {
+			    Swm__win_to_client(trans)) {
+				Client__set_floating(client, 1);
 				Swm__arrange_monitors(client->mon);
 			}
 			break;
@@ -437,9 +475,9 @@ void Swm__event_property_notify(XEvent *event)
 
 		if (ev->atom == XA_WM_NAME ||
 		    ev->atom == g_swm.netatom[SlackerEWMHAtom_NetWMName]) {
-			Swm__update_client_title(client);
-			if (client == client->mon->selected_client) {
-				Swm__drawbar(client->mon);
+			if (Swm__update_client_title(client) &&
+			    client == client->mon->selected_client) {
+				Swm__schedule_drawbar(client->mon);
 			}
 		}
 
@@ -447,6 +485,13 @@ void Swm__event_property_notify(XEvent *event)
 		    g_swm.netatom[SlackerEWMHAtom_NetWMWindowType]) {
 			Swm__update_window_type(client);
 		}
+
+		if (ev->atom == g_swm.wmatom[SlackerDefaultAtom_WMProtocols] ||
+		    ev->atom ==
+			    g_swm.netatom
+				    [SlackerEWMHAtom_NetWMSyncRequestCounter]) {
+			Swm__update_sync_counter(client);
+		}
 	}
 }
 
@@ -19,6 +19,17 @@ void Swm__event_loop(XEvent *event);
 /// https://tronche.com/gui/x/xlib/events/keyboard-pointer/keyboard-pointer.html
 void Swm__event_button_press(XEvent *event);
 
+/// @brief Handles X11 ButtonRelease events
+///
+/// @details Ends a mouse move or resize started by a button binding, see drag.h
+void Swm__event_button_release(XEvent *event);
+
+/// @brief Handles SYNC extension AlarmNotify events
+///
+/// @details Clients answering a _NET_WM_SYNC_REQUEST trigger these, a resize
+/// drag waits for them before sending the next size.
+void Swm__event_sync_alarm(XEvent *event);
+
 /// @brief Handles X11 ClientMessage events
 ///
 /// @details The X server generates ClientMessage events only when a client calls the function XSendEvent().
@@ -41,6 +52,8 @@ void Swm__event_configure_request(XEvent *event);
 /// such as size, position, border, and stacking order. The X server generates this event type
 /// whenever one of the following configure window requests made by a client application actually completes:
 ///
+/// Root window changes only schedule a monitor update, see `Swm__schedule_monitor_update`.
+///
 /// https://tronche.com/gui/x/xlib/events/window-state-change/configure.html
 void Swm__event_configure_notify(XEvent *event);
 
@@ -114,6 +127,8 @@ void Swm__event_map_request(XEvent *event);
 /// The granularity of MotionNotify events is not guaranteed, but a client that selects this event type is guaranteed to
 /// receive at least one event when the pointer moves and then rests.
 ///
+/// Only drags grab the pointer motion, see drag.h.
+///
 /// https://tronche.com/gui/x/xlib/events/keyboard-pointer/keyboard-pointer.html
 void Swm__event_motion_notify(XEvent *event);
 
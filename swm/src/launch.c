@@ -0,0 +1,283 @@
+// X11 Libraries
+#include <X11/Xatom.h>
+#include <X11/Xlib.h>
+
+// Standard Libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Slacker Headers
+#include "launch.h"
+#include "swm.h"
+#include "timing.h"
+#include "utils.h"
+
+/// @brief Reads the parent of a process from /proc.
+///
+/// @returns The parent pid, 0 if the process is gone
+static pid_t Launch__parent(pid_t pid)
+{
+	char path[32];
+	char buffer[512];
+	char *fields = NULL;
+	int32_t ppid = 0;
+	size_t len = 0;
+	FILE *file = NULL;
+
+	snprintf(path, sizeof(path), "/proc/%d/stat", (int)pid);
+	if (!(file = fopen(path, "r"))) {
+		return 0;
+	}
+	len = fread(buffer, 1, sizeof(buffer) - 1, file);
+	fclose(file);
+	buffer[len] = '\0';
+
+	// The command name may contain spaces and parentheses itself
+	if (!(fields = strrchr(buffer, ')')) ||
+	    sscanf(fields + 1, " %*c %d", &ppid) != 1) {
+		return 0;
+	}
+	return ppid;
+}
+
+/// @brief Reads _NET_WM_PID of a window.
+///
+/// @returns The pid, 0 if the window doesn't set it
+static pid_t Launch__window_pid(Window w_id)
+{
+	Atom type = None;
+	int32_t format = 0;
+	unsigned long items = 0;
+	unsigned long remaining = 0;
+	unsigned char *data = NULL;
+	pid_t pid = 0;
+
+	if (XGetWindowProperty(g_swm.ctx.xconn, w_id,
+			       g_swm.netatom[SlackerEWMHAtom_NetWMPid], 0, 1,
+			       False, XA_CARDINAL, &type, &format, &items,
+			       &remaining, &data) == Success &&
+	    data) {
+		if (format == 32 && items == 1) {
+			pid = *(long *)data;
+		}
+		XFree(data);
+	}
+	return pid;
+}
+
+static int Launch__compare(const void *a, const void *b)
+{
+	uint32_t x = *(const uint32_t *)a;
+	uint32_t y = *(const uint32_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+/// @brief Formats p50, p90 and p99 of a sample ring in milliseconds.
+static int32_t Launch__percentiles(char *text, size_t size,
+				   const uint32_t *samples, uint32_t count)
+{
+	uint32_t sorted[LAUNCH_SAMPLES];
+	uint32_t n = MIN(count, LAUNCH_SAMPLES);
+
+	if (!n) {
+		return snprintf(text, size, "n=0");
+	}
+
+	memcpy(sorted, samples, n * sizeof(uint32_t));
+	qsort(sorted, n, sizeof(uint32_t), Launch__compare);
+	return snprintf(text, size, "n=%u p50=%.1f p90=%.1f p99=%.1f ms", n,
+			sorted[(n - 1) * 50 / 100] / 1000.0,
+			sorted[(n - 1) * 90 / 100] / 1000.0,
+			sorted[(n - 1) * 99 / 100] / 1000.0);
+}
+
+/// @brief Writes the percentiles of every command to _SWM_LAUNCH_STATS.
+static void Launch__publish(void)
+{
+	Launches *launches = &g_swm.launches;
+	char text[MAX_LAUNCH_STATS_LEN];
+	size_t len = 0;
+	int32_t n = 0;
+
+	text[0] = '\0';
+	for (uint32_t i = 0; i < launches->stats_size && len < sizeof(text);
+	     ++i) {
+		LaunchStats *stats = &launches->stats[i];
+
+		n = snprintf(text + len, sizeof(text) - len,
+			     "%s: launch to map ", stats->cmd);
+		len = MIN(len + MAX(n, 0), sizeof(text) - 1);
+		n = Launch__percentiles(text + len, sizeof(text) - len,
+					stats->map_us, stats->map_count);
+		len = MIN(len + MAX(n, 0), sizeof(text) - 1);
+		n = snprintf(text + len, sizeof(text) - len,
+			     ", map to expose ");
+		len = MIN(len + MAX(n, 0), sizeof(text) - 1);
+		n = Launch__percentiles(text + len, sizeof(text) - len,
+					stats->expose_us,
+					stats->expose_count);
+		len = MIN(len + MAX(n, 0), sizeof(text) - 1);
+		n = snprintf(text + len, sizeof(text) - len, "\n");
+		len = MIN(len + MAX(n, 0), sizeof(text) - 1);
+	}
+
+	XChangeProperty(g_swm.ctx.xconn, g_swm.ctx.xroot_id,
+			g_swm.wmatom[SlackerDefaultAtom_SwmLaunchStats],
+			XA_STRING, 8, PropModeReplace, (unsigned char *)text,
+			len);
+}
+
+static LaunchStats *Launch__stats(const char *cmd)
+{
+	Launches *launches = &g_swm.launches;
+	LaunchStats *stats = NULL;
+
+	for (uint32_t i = 0; i < launches->stats_size; ++i) {
+		if (!strcmp(launches->stats[i].cmd, cmd)) {
+			return &launches->stats[i];
+		}
+	}
+
+	if (launches->stats_size >= MAX_LAUNCH_COMMANDS) {
+		return NULL;
+	}
+	stats = &launches->stats[launches->stats_size++];
+	memset(stats, 0, sizeof(LaunchStats));
+	stats->cmd = cmd;
+	return stats;
+}
+
+/// @brief Forgets launches which never showed a window.
+static void Launch__expire(uint64_t now_us)
+{
+	Launches *launches = &g_swm.launches;
+	uint32_t kept = 0;
+
+	for (uint32_t i = 0; i < launches->pending_size; ++i) {
+		if (now_us - launches->pending[i].spawn_us <
+		    LAUNCH_TIMEOUT_MS * 1000ULL) {
+			launches->pending[kept++] = launches->pending[i];
+		}
+	}
+	launches->pending_size = kept;
+}
+
+void Launch__spawned(pid_t pid, const char *cmd, uint64_t spawn_us,
+		     const Monitor *monitor)
+{
+	Launches *launches = &g_swm.launches;
+
+	Launch__expire(spawn_us);
+	if (pid <= 0 || launches->pending_size >= MAX_PENDING_LAUNCHES) {
+		return;
+	}
+
+	launches->pending[launches->pending_size++] = (LaunchPending){
+		.pid = pid,
+		.stats = Launch__stats(cmd),
+		.spawn_us = spawn_us,
+		.monitor = Monitor__handle(monitor),
+		.tags = monitor->tag_set[monitor->selected_tags],
+	};
+}
+
+/// @brief Puts a client where the launch it belongs to was spawned from.
+static void Launch__place(Client *client, const LaunchPending *launch)
+{
+	Monitor *monitor = Monitor__from_handle(launch->monitor);
+
+	// The monitor was unplugged since, then it stays put
+	if (!monitor) {
+		return;
+	}
+
+	if (monitor != client->mon) {
+		client->mon = monitor;
+		Client__clamp_to_monitor(client);
+	}
+	client->tags = launch->tags;
+}
+
+void Launch__match(Client *client)
+{
+	Launches *launches = &g_swm.launches;
+	pid_t self = getpid();
+	pid_t pid = 0;
+
+	// Nothing may have been spawned since, which would have expired them
+	Launch__expire(Timing__now_us());
+	if (!launches->pending_size ||
+	    !(pid = Launch__window_pid(client->win))) {
+		return;
+	}
+
+	// The spawned pid may be a wrapper script which started the program
+	for (uint32_t depth = 0; depth < LAUNCH_MAX_DEPTH && pid > 1 &&
+				 pid != self;
+	     ++depth, pid = Launch__parent(pid)) {
+		for (uint32_t i = 0; i < launches->pending_size; ++i) {
+			if (launches->pending[i].pid != pid) {
+				continue;
+			}
+
+			Launch__place(client, &launches->pending[i]);
+			client->launch_stats = launches->pending[i].stats;
+			launches->awaiting_expose += !!client->launch_stats;
+			client->launch_us = launches->pending[i].spawn_us;
+			// Only the first window of a launch counts
+			launches->pending[i] =
+				launches->pending[--launches->pending_size];
+			return;
+		}
+	}
+}
+
+void Launch__mapped(Client *client)
+{
+	LaunchStats *stats = client->launch_stats;
+
+	if (!stats) {
+		return;
+	}
+
+	client->map_us = Timing__now_us();
+	stats->map_us[stats->map_count++ % LAUNCH_SAMPLES] =
+		client->map_us - client->launch_us;
+#if (DEBUG == true)
+	fprintf(stdout, "launch: '%s' mapped after %.1f ms\n", stats->cmd,
+		(client->map_us - client->launch_us) / 1000.0);
+#endif
+	Launch__publish();
+}
+
+void Launch__exposed(Client *client)
+{
+	LaunchStats *stats = client->launch_stats;
+	uint64_t now_us = Timing__now_us();
+
+	if (!stats) {
+		return;
+	}
+
+	stats->expose_us[stats->expose_count++ % LAUNCH_SAMPLES] =
+		now_us - client->map_us;
+#if (DEBUG == true)
+	fprintf(stdout, "launch: '%s' exposed %.1f ms after mapping\n",
+		stats->cmd, (now_us - client->map_us) / 1000.0);
+#endif
+	Launch__publish();
+
+	Launch__forget(client);
+	XSelectInput(g_swm.ctx.xconn, client->win, CLIENTMASK);
+}
+
+void Launch__forget(Client *client)
+{
+	if (client->launch_stats) {
+		client->launch_stats = NULL;
+		--g_swm.launches.awaiting_expose;
+	}
+}
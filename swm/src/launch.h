@@ -0,0 +1,85 @@
+#ifndef SWM_LAUNCH_H
+#define SWM_LAUNCH_H
+
+/// Launch latency of the programs started by `Swm__spawn`.
+///
+/// Spawned pids are remembered until a window with a matching _NET_WM_PID
+/// is managed, wrapper scripts are found by walking up the process tree.
+/// Rolling percentiles per command are published on the root window, read
+/// them with `xprop -root _SWM_LAUNCH_STATS`.
+
+// Standard Libraries
+#include <stdint.h>
+#include <sys/types.h>
+
+// Slacker Headers
+#include "client.h"
+#include "constants.h"
+
+typedef struct LaunchPending LaunchPending;
+typedef struct LaunchStats LaunchStats;
+typedef struct Launches Launches;
+
+/// A spawned program without a window yet
+struct LaunchPending {
+	pid_t pid;
+	/// Statistics of the command that was spawned, NULL if the table is
+	/// full
+	LaunchStats *stats;
+	/// Monotonic time in microseconds of the spawn
+	uint64_t spawn_us;
+	/// Handle of the selected monitor and its tags at the spawn
+	uint32_t monitor;
+	uint32_t tags;
+};
+
+/// Latency samples of one command, the last LAUNCH_SAMPLES are kept
+struct LaunchStats {
+	/// argv[0] of the command
+	const char *cmd;
+	/// Samples recorded so far, also the next ring index
+	uint32_t map_count, expose_count;
+	/// Spawn to map and map to first expose, in microseconds
+	uint32_t map_us[LAUNCH_SAMPLES];
+	uint32_t expose_us[LAUNCH_SAMPLES];
+};
+
+/// @brief All launch tracking state, lives in `g_swm.launches`.
+struct Launches {
+	LaunchPending pending[MAX_PENDING_LAUNCHES];
+	uint32_t pending_size;
+	LaunchStats stats[MAX_LAUNCH_COMMANDS];
+	uint32_t stats_size;
+	/// Clients which select ExposureMask until their first expose
+	uint32_t awaiting_expose;
+};
+
+/// @brief Remembers a spawned program until its window shows up.
+///
+/// @param `pid` The process id of the program
+/// @param `cmd` argv[0] of the program, has to outlive the WM
+/// @param `spawn_us` Monotonic time in microseconds the launch started at
+/// @param `monitor` The selected monitor at the spawn
+void Launch__spawned(pid_t pid, const char *cmd, uint64_t spawn_us,
+		     const Monitor *monitor);
+
+/// @brief Matches a new window to a pending launch through _NET_WM_PID.
+///
+/// @details On a match the client is put on the monitor and tags it was
+/// spawned from, window rules may still override them. Sets
+/// `Client::launch_stats`, the caller then selects ExposureMask on the
+/// window. Costs a round trip, skipped while nothing is pending.
+void Launch__match(Client *client);
+
+/// @brief Records the launch to map latency, call right after mapping.
+void Launch__mapped(Client *client);
+
+/// @brief Records the map to first expose latency and stops tracking the
+/// client.
+void Launch__exposed(Client *client);
+
+/// @brief Stops tracking a client which is unmanaged before its first
+/// expose.
+void Launch__forget(Client *client);
+
+#endif
@@ -29,30 +29,37 @@ int main(int argc, char **argv)
 
 #if (DEBUG == false)
 		fprintf(stdout, "Running in release mode\n");
-		Autostart__add(&as, "xset r rate 200 60");
-		Autostart__add(&as, "setxkbmap -option ctrl:nocaps");
-		Autostart__add(&as, "picom");
-		Autostart__add(&as, "dunst");
-		Autostart__add(&as, "slacker_update_bar.sh");
-		Autostart__add(
-			&as,
-			"feh --bg-fill /usr/local/share/slacker/background.png");
-
 		// NOTE: Example for ultra wide monitor on Display port (GPU) with 144hz refresh rate
-		Autostart__add(
+		int32_t xrandr = Autostart__add(
 			&as,
-			"xrandr --output DisplayPort-2 --mode 3840x1080 --rate 143.85");
+			"xrandr --output DisplayPort-2 --mode 3840x1080 --rate 143.85",
+			SlackerAutostart_Once, -1);
 
 		// NOTE: Example for built-in laptop screen for Dell xps 13
-		// Autostart__add(
+		// int32_t xrandr = Autostart__add(
 		// &as,
-		// "xrandr --output eDP-1 --mode 1920x1200 --rate 59.95");
+		// "xrandr --output eDP-1 --mode 1920x1200 --rate 59.95",
+		// SlackerAutostart_Once, -1);
+
+		Autostart__add(&as, "xset r rate 200 60", SlackerAutostart_Once,
+			       -1);
+		Autostart__add(&as, "setxkbmap -option ctrl:nocaps",
+			       SlackerAutostart_Once, -1);
+		Autostart__add(&as, "picom", SlackerAutostart_Restart, xrandr);
+		Autostart__add(&as, "dunst", SlackerAutostart_Restart, -1);
+		Autostart__add(&as, "slacker_update_bar.sh",
+			       SlackerAutostart_Once, -1);
+		// The wallpaper is scaled to the final output size
+		Autostart__add(
+			&as,
+			"feh --bg-fill /usr/local/share/slacker/background.png",
+			SlackerAutostart_Once, xrandr);
 
 		Autostart__exec(&as);
 #endif
 
 		Swm__startup();
-		Swm__run();
+		Swm__run(&as);
 		Swm__delete();
 		Autostart__kill(&as);
 		clean_environment();
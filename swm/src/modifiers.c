@@ -1,13 +1,17 @@
 /// Standard Libraries
+#include <errno.h>
 #include <signal.h>
+#include <stdio.h>
 #include <unistd.h>
 
 // Slacker Headers
 #include "common.h"
+#include "drag.h"
 #include "events.h"
 #include "modifiers.h"
 #include "monitor.h"
 #include "swm.h"
+#include "timing.h"
 #include "utils.h"
 #include "error.h"
 #include <string.h>
@@ -20,14 +24,14 @@ void Swm__kill_client(const Arg *arg)
 
 	if (!Swm__send_event(g_swm.selected_monitor->selected_client,
 			     g_swm.wmatom[SlackerDefaultAtom_WMDelete])) {
-		XGrabServer(g_swm.ctx.xconn);
+		Swm__grab_server();
 		XSetErrorHandler(xerrordummy);
 		XSetCloseDownMode(g_swm.ctx.xconn, DestroyAll);
 		XKillClient(g_swm.ctx.xconn,
 			    g_swm.selected_monitor->selected_client->win);
 		XSync(g_swm.ctx.xconn, False);
 		XSetErrorHandler(Swm__xerror_handler);
-		XUngrabServer(g_swm.ctx.xconn);
+		Swm__ungrab_server();
 	}
 }
 
@@ -38,18 +42,20 @@ void Swm__increment_n_master(const Arg *arg)
 	Swm__arrange_monitors(active);
 }
 
+/// @brief Decides if a drag only draws an outline of the client.
+///
+/// @details Either the window rule of the client asks for it or the drag was
+/// started from a binding with `SlackerDrag_Outline` as argument.
+static bool Swm__drag_outline(const Arg *arg, const Client *client)
+{
+	return client->outline_drag || (arg && arg->i == SlackerDrag_Outline);
+}
+
 void Swm__move_with_mouse(const Arg *arg)
 {
 	int32_t x = 0;
 	int32_t y = 0;
-	int32_t ocx = 0;
-	int32_t ocy = 0;
-	int32_t nx = 0;
-	int32_t ny = 0;
 	Client *temp_client = 0;
-	Monitor *temp_monitor = NULL;
-	Time lasttime = 0;
-	XEvent ev;
 
 	// If there is no selected client, return.
 	if (!(temp_client = g_swm.selected_monitor->selected_client)) {
@@ -62,8 +68,6 @@ void Swm__move_with_mouse(const Arg *arg)
 	}
 
 	Swm__restack(g_swm.selected_monitor);
-	ocx = temp_client->x;
-	ocy = temp_client->y;
 
 	if (XGrabPointer(g_swm.ctx.xconn, g_swm.ctx.xroot_id, False, MOUSEMASK,
 			 GrabModeAsync, GrabModeAsync, None,
@@ -74,83 +78,13 @@ void Swm__move_with_mouse(const Arg *arg)
 
 	// If window is invalid, return.
 	if (!Swm__getrootptr(&x, &y)) {
+		XUngrabPointer(g_swm.ctx.xconn, CurrentTime);
 		return;
 	}
 
-	do {
-		XMaskEvent(g_swm.ctx.xconn,
-			   MOUSEMASK | ExposureMask | SubstructureRedirectMask,
-			   &ev);
-		switch (ev.type) {
-		case ConfigureRequest:
-		case Expose:
-		case MapRequest:
-			Swm__event_loop(&ev);
-			break;
-		case MotionNotify:
-			if ((ev.xmotion.time - lasttime) <= (1000 / 60)) {
-				continue;
-			}
-			lasttime = ev.xmotion.time;
-
-			nx = ocx + (ev.xmotion.x - x);
-			ny = ocy + (ev.xmotion.y - y);
-
-			if (abs(g_swm.selected_monitor->wx - nx) <
-			    G_SNAP_PIXEL) {
-				nx = g_swm.selected_monitor->wx;
-			} else if (((g_swm.selected_monitor->wx +
-				     g_swm.selected_monitor->ww) -
-				    (nx + WIDTH(temp_client))) < G_SNAP_PIXEL) {
-				nx = g_swm.selected_monitor->wx +
-				     g_swm.selected_monitor->ww -
-				     WIDTH(temp_client);
-			}
-
-			if (abs(g_swm.selected_monitor->wy - ny) <
-			    G_SNAP_PIXEL) {
-				ny = g_swm.selected_monitor->wy;
-			} else if (((g_swm.selected_monitor->wy +
-				     g_swm.selected_monitor->wh) -
-				    (ny + HEIGHT(temp_client))) <
-				   G_SNAP_PIXEL) {
-				ny = g_swm.selected_monitor->wy +
-				     g_swm.selected_monitor->wh -
-				     HEIGHT(temp_client);
-			}
-
-			if (!temp_client->isfloating &&
-			    g_swm.selected_monitor
-				    ->layouts[g_swm.selected_monitor
-						      ->selected_layout]
-				    ->handler &&
-			    (abs(nx - temp_client->x) > G_SNAP_PIXEL ||
-			     abs(ny - temp_client->y) > G_SNAP_PIXEL)) {
-				Swm__togglefloating(NULL);
-			}
-
-			if (!g_swm.selected_monitor
-				     ->layouts[g_swm.selected_monitor
-						       ->selected_layout]
-				     ->handler ||
-			    temp_client->isfloating) {
-				Client__resize(temp_client, nx, ny,
-					       temp_client->w, temp_client->h,
-					       1);
-			}
-			break;
-		}
-	} while (ev.type != ButtonRelease);
-
-	XUngrabPointer(g_swm.ctx.xconn, CurrentTime);
-
-	if ((temp_monitor = Swm__rect_to_monitor(
-		     temp_client->x, temp_client->y, temp_client->w,
-		     temp_client->h)) != g_swm.selected_monitor) {
-		Client__send_to_monitor(temp_client, temp_monitor);
-		g_swm.selected_monitor = temp_monitor;
-		Swm__focus(NULL);
-	}
+	// The main loop takes it from here until the button is released
+	Drag__begin(SlackerDragKind_Move, temp_client,
+		    Swm__drag_outline(arg, temp_client), x, y);
 }
 
 void Swm__quit(const Arg *arg)
@@ -160,15 +94,9 @@ void Swm__quit(const Arg *arg)
 
 void Swm__resize_client_with_mouse(const Arg *arg)
 {
-	// TODO: Refactor, this function
-	int32_t ocx = 0;
-	int32_t ocy = 0;
-	int32_t nw = 0;
-	int32_t nh = 0;
+	int32_t x = 0;
+	int32_t y = 0;
 	Client *temp_client = NULL;
-	Monitor *temp_monitor = NULL;
-	XEvent ev;
-	Time lasttime = 0;
 
 	// If there is no selected client on the selected monitor, return.
 	if (!(temp_client = g_swm.selected_monitor->selected_client)) {
@@ -181,8 +109,6 @@ void Swm__resize_client_with_mouse(const Arg *arg)
 	}
 
 	Swm__restack(g_swm.selected_monitor);
-	ocx = temp_client->x;
-	ocy = temp_client->y;
 
 	if (XGrabPointer(g_swm.ctx.xconn, g_swm.ctx.xroot_id, False, MOUSEMASK,
 			 GrabModeAsync, GrabModeAsync, None,
@@ -191,80 +117,16 @@ void Swm__resize_client_with_mouse(const Arg *arg)
 		return;
 	}
 
+	// Only used to pick the refresh rate of the monitor
+	Swm__getrootptr(&x, &y);
+
 	XWarpPointer(g_swm.ctx.xconn, None, temp_client->win, 0, 0, 0, 0,
 		     temp_client->w + temp_client->bw - 1,
 		     temp_client->h + temp_client->bw - 1);
-	do {
-		XMaskEvent(g_swm.ctx.xconn,
-			   MOUSEMASK | ExposureMask | SubstructureRedirectMask,
-			   &ev);
-
-		switch (ev.type) {
-		case ConfigureRequest:
-		case Expose:
-		case MapRequest:
-			Swm__event_loop(&ev);
-			break;
-		case MotionNotify:
-			if ((ev.xmotion.time - lasttime) <= (1000 / 60)) {
-				continue;
-			}
-			lasttime = ev.xmotion.time;
-
-			nw = MAX((ev.xmotion.x - ocx - 2 * temp_client->bw + 1),
-				 1);
-			nh = MAX((ev.xmotion.y - ocy - 2 * temp_client->bw + 1),
-				 1);
-
-			if (temp_client->mon->wx + nw >=
-				    g_swm.selected_monitor->wx &&
-			    temp_client->mon->wx + nw <=
-				    g_swm.selected_monitor->wx +
-					    g_swm.selected_monitor->ww &&
-			    temp_client->mon->wy + nh >=
-				    g_swm.selected_monitor->wy &&
-			    temp_client->mon->wy + nh <=
-				    g_swm.selected_monitor->wy +
-					    g_swm.selected_monitor->wh) {
-				if (!temp_client->isfloating &&
-				    g_swm.selected_monitor
-					    ->layouts[g_swm.selected_monitor
-							      ->selected_layout]
-					    ->handler &&
-				    (abs(nw - temp_client->w) > G_SNAP_PIXEL ||
-				     abs(nh - temp_client->h) > G_SNAP_PIXEL))
-					Swm__togglefloating(NULL);
-			}
-
-			if (!g_swm.selected_monitor
-				     ->layouts[g_swm.selected_monitor
-						       ->selected_layout]
-				     ->handler ||
-			    temp_client->isfloating) {
-				Client__resize(temp_client, temp_client->x,
-					       temp_client->y, nw, nh, 1);
-			}
-			break;
-		}
-	} while (ev.type != ButtonRelease);
-
-	XWarpPointer(g_swm.ctx.xconn, None, temp_client->win, 0, 0, 0, 0,
-		     temp_client->w + (temp_client->bw - 1),
-		     temp_client->h + (temp_client->bw - 1));
-
-	XUngrabPointer(g_swm.ctx.xconn, CurrentTime);
 
-	while (XCheckMaskEvent(g_swm.ctx.xconn, EnterWindowMask, &ev)) {
-		;
-	}
-
-	if ((temp_monitor = Swm__rect_to_monitor(
-		     temp_client->x, temp_client->y, temp_client->w,
-		     temp_client->h)) != g_swm.selected_monitor) {
-		Client__send_to_monitor(temp_client, temp_monitor);
-		g_swm.selected_monitor = temp_monitor;
-		Swm__focus(NULL);
-	}
+	// The main loop takes it from here until the button is released
+	Drag__begin(SlackerDragKind_Resize, temp_client,
+		    Swm__drag_outline(arg, temp_client), x, y);
 }
 
 void Swm__setlayout(const Arg *arg)
@@ -310,27 +172,28 @@ void Swm__setmfact(const Arg *arg)
 	Swm__arrange_monitors(sm);
 }
 
+/// @brief Time from the binding firing until the program has been exec'd.
+static TimingStats s_spawn_stats = { "spawn" };
+
 void Swm__spawn(const Arg *arg)
 {
-	struct sigaction sa;
+	uint64_t start_us = Timing__now_us();
+	pid_t pid = -1;
 
 	if (arg->v == G_DMENU_COMMAND) {
 		G_DMENU_MONITOR[0] = '0' + g_swm.selected_monitor->num;
 	}
 
-	if (fork() == 0) {
-		if (g_swm.ctx.xconn) {
-			close(ConnectionNumber(g_swm.ctx.xconn));
-		}
-		setsid();
-
-		sigemptyset(&sa.sa_mask);
-		sa.sa_flags = 0;
-		sa.sa_handler = SIG_DFL;
-		sigaction(SIGCHLD, &sa, NULL);
-
-		execvp(((char **)arg->v)[0], (char **)arg->v);
-		die("slacker: execvp '%s' failed:", ((char **)arg->v)[0]);
+	// The X connection is close-on-exec, see `Ctx__new`
+	if (spawn_process((char *const *)arg->v, &pid) == 0) {
+		TimingStats__record(&s_spawn_stats,
+				    Timing__now_us() - start_us);
+		TimingStats__log(&s_spawn_stats);
+		Launch__spawned(pid, ((char **)arg->v)[0], start_us,
+				g_swm.selected_monitor);
+	} else {
+		fprintf(stderr, "slacker: spawn '%s' failed: %s\n",
+			((char **)arg->v)[0], strerror(errno));
 	}
 }
 
@@ -338,7 +201,7 @@ void Swm__tag(const Arg *arg)
 {
 	Monitor *sm = g_swm.selected_monitor;
 	if (sm->selected_client && arg->ui & TAGMASK) {
-		sm->selected_client->tags = arg->ui & TAGMASK;
+		Client__set_tags(sm->selected_client, arg->ui & TAGMASK);
 		Swm__focus(NULL);
 		Swm__arrange_monitors(sm);
 	}
@@ -364,7 +227,7 @@ void Swm__togglebar(const Arg *arg)
 	sm->show_bar = !sm->show_bar;
 	Monitor__updatebarpos(sm);
 	XMoveResizeWindow(g_swm.ctx.xconn, sm->bar_win_id, sm->wx, sm->bar_y,
-			  sm->ww, g_swm.bar_height);
+			  sm->ww, sm->bar_scale->bar_height);
 	Swm__arrange_monitors(sm);
 }
 
@@ -380,8 +243,9 @@ void Swm__togglefloating(const Arg *arg)
 		return;
 	}
 
-	sm->selected_client->isfloating = !sm->selected_client->isfloating ||
-					  sm->selected_client->isfixed;
+	Client__set_floating(sm->selected_client,
+			     !sm->selected_client->isfloating ||
+				     sm->selected_client->isfixed);
 
 	if (sm->selected_client->isfloating) {
 		Client__resize(sm->selected_client, sm->selected_client->x,
@@ -402,7 +266,7 @@ void Swm__toggletag(const Arg *arg)
 
 	uint32_t newtags = sm->selected_client->tags ^ (arg->ui & TAGMASK);
 	if (newtags) {
-		sm->selected_client->tags = newtags;
+		Client__set_tags(sm->selected_client, newtags);
 		Swm__focus(NULL);
 		Swm__arrange_monitors(sm);
 	}
@@ -419,15 +283,32 @@ void Swm__toggleview(const Arg *arg)
 			     (arg->ui & TAGMASK);
 
 	if (newtagset) {
+		Monitor__save_tag_state(sm);
 		sm->tag_set[sm->selected_tags] = newtagset;
-		Swm__focus(NULL);
+
+		// Keep the layout of the current tag while it stays in view
+		if (newtagset == TAGMASK) {
+			sm->previous_tag = sm->current_tag;
+			sm->current_tag = 0;
+		} else if (!sm->current_tag ||
+			   !(newtagset & 1 << (sm->current_tag - 1))) {
+			sm->previous_tag = sm->current_tag;
+			sm->current_tag = Monitor__tag_index(newtagset);
+		}
+
+		Swm__focus(Monitor__load_tag_state(sm));
 		Swm__arrange_monitors(sm);
 	}
 }
 
+/// @brief Tag switch latency, see bench/view.c for the part which doesn't
+/// talk to the server at 50, 200 and 1000 clients.
+static TimingStats s_view_stats = { "view" };
+
 void Swm__view(const Arg *arg)
 {
 	Monitor *sm = g_swm.selected_monitor;
+	uint64_t start_us = 0;
 	if (!sm) {
 		return;
 	}
@@ -436,14 +317,14 @@ void Swm__view(const Arg *arg)
 		return;
 	}
 
-	// Toggle selected tag set for the active monitor.
-	sm->selected_tags ^= 1;
-	if (arg->ui & TAGMASK) {
-		sm->tag_set[sm->selected_tags] = arg->ui & TAGMASK;
-	}
-
-	Swm__focus(NULL);
-	Swm__arrange_monitors(sm);
+	start_us = Timing__now_us();
+	// Arranged before the show and hide pass, the clients coming into
+	// view are moved in at their new geometry
+	Swm__focus(Monitor__view(sm, arg->ui));
+	Swm__showhide(sm->client_stack);
+	Swm__restack(sm);
+	TimingStats__record(&s_view_stats, Timing__now_us() - start_us);
+	TimingStats__log(&s_view_stats);
 }
 
 void Swm__zoom(const Arg *arg)
@@ -498,16 +379,16 @@ void Swm__focus_stack(const Arg *arg)
 			}
 		}
 	} else {
-		Client *iter = NULL;
-		for (iter = sm->client_list; iter != sm->selected_client;
-		     iter = iter->next) {
-			if (ISVISIBLE(iter)) {
-				temp_client = iter;
-			}
+		for (temp_client = sm->selected_client->prev;
+		     temp_client && !ISVISIBLE(temp_client);
+		     temp_client = temp_client->prev) {
+			;
 		}
 
+		// Wrap around to the last visible client
 		if (!temp_client) {
-			for (; iter; iter = iter->next) {
+			for (Client *iter = sm->selected_client; iter;
+			     iter = iter->next) {
 				if (ISVISIBLE(iter)) {
 					temp_client = iter;
 				}
@@ -1,4 +1,6 @@
 /// Standard Library
+#include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -12,7 +14,7 @@ Monitor *Monitor__new(void)
 {
 	Monitor *m;
 
-	m = ecalloc(1, sizeof(Monitor));
+	m = Pool__alloc(&g_swm.monitor_pool);
 	m->tag_set[0] = m->tag_set[1] = 1;
 	m->master_width_factor = G_MASTER_FACTOR;
 	m->num_master = G_MASTER_COUNT;
@@ -21,6 +23,14 @@ Monitor *Monitor__new(void)
 	m->layouts[0] = &G_LAYOUTS[0];
 	m->layouts[1] = &G_LAYOUTS[1 % LENGTH(G_LAYOUTS)];
 	strncpy(m->layout_symbol, G_LAYOUTS[0].symbol, sizeof m->layout_symbol);
+	m->current_tag = m->previous_tag = 1;
+
+	for (uint32_t i = 0; i < LENGTH(m->tag_state); ++i) {
+		m->tag_state[i].master_width_factor = m->master_width_factor;
+		m->tag_state[i].num_master = m->num_master;
+		m->tag_state[i].selected_layout = m->selected_layout;
+		memcpy(m->tag_state[i].layouts, m->layouts, sizeof m->layouts);
+	}
 	return m;
 }
 
@@ -38,20 +48,289 @@ void Monitor__delete(Monitor *monitor)
 		}
 		temp_mon->next = monitor->next;
 	}
-	XUnmapWindow(g_swm.ctx.xconn, monitor->bar_win_id);
-	XDestroyWindow(g_swm.ctx.xconn, monitor->bar_win_id);
-	free(monitor);
+	if (monitor->bar_win_id) {
+		XUnmapWindow(g_swm.ctx.xconn, monitor->bar_win_id);
+		XDestroyWindow(g_swm.ctx.xconn, monitor->bar_win_id);
+	}
+	if (monitor->draw) {
+		// The fonts belong to the bar scale
+		monitor->draw->fonts = NULL;
+		drw_free(monitor->draw);
+	}
+	if (monitor->backdrop_win_id) {
+		XDestroyWindow(g_swm.ctx.xconn, monitor->backdrop_win_id);
+	}
+	for (uint32_t i = 0; i < LENGTH(monitor->tag_state); ++i) {
+		free(monitor->tag_state[i].cache.entries);
+	}
+	Pool__free(&g_swm.monitor_pool, monitor);
 }
 
-void Monitor__arrange(Monitor *monitor)
+uint32_t Monitor__handle(const Monitor *monitor)
+{
+	return Pool__handle(&g_swm.monitor_pool, monitor);
+}
+
+Monitor *Monitor__from_handle(uint32_t handle)
+{
+	return Pool__get(&g_swm.monitor_pool, handle);
+}
+
+/// @brief Folds one value into a layout cache key
+static uint64_t Monitor__hash(uint64_t hash, uint64_t value)
+{
+	return fnv1a(hash, &value, sizeof(value));
+}
+
+/// @brief Hashes everything the layout handler of a monitor reads.
+static uint64_t Monitor__layout_key(Monitor *monitor)
+{
+	uint64_t key = FNV1A_OFFSET_BASIS;
+	uint32_t mfact_bits = 0;
+	Client *c = NULL;
+
+	memcpy(&mfact_bits, &monitor->master_width_factor, sizeof(mfact_bits));
+	key = Monitor__hash(
+		key, (uintptr_t)monitor->layouts[monitor->selected_layout]
+			     ->handler);
+	key = Monitor__hash(key, monitor->tag_set[monitor->selected_tags]);
+	key = Monitor__hash(key, mfact_bits);
+	key = Monitor__hash(key, (uint32_t)monitor->num_master);
+	key = Monitor__hash(key, ((uint64_t)(uint32_t)monitor->wx << 32) |
+					 (uint32_t)monitor->wy);
+	key = Monitor__hash(key, ((uint64_t)(uint32_t)monitor->ww << 32) |
+					 (uint32_t)monitor->wh);
+	// Gaps and borders depend on the number of visible clients
+	key = Monitor__hash(key, Monitor__get_num_clients(monitor));
+
+	for (c = Client__next_tiled(monitor->client_list); c;
+	     c = Client__next_tiled(c->next)) {
+		key = Monitor__hash(key, (uintptr_t)c);
+		key = Monitor__hash(key, (uint32_t)c->bw);
+	}
+	return key;
+}
+
+/// @brief Checks that every tiled client still has the geometry stored in the cache.
+static bool Monitor__layout_cache_matches(Monitor *monitor,
+					  const LayoutCache *cache)
+{
+	uint32_t i = 0;
+	Client *c = NULL;
+
+	for (c = Client__next_tiled(monitor->client_list); c;
+	     c = Client__next_tiled(c->next), ++i) {
+		if (i >= cache->size || cache->entries[i].client != c ||
+		    cache->entries[i].x != c->x || cache->entries[i].y != c->y ||
+		    cache->entries[i].w != c->w || cache->entries[i].h != c->h) {
+			return false;
+		}
+	}
+	return i == cache->size;
+}
+
+/// @brief Records the geometry the layout handler just produced.
+static void Monitor__layout_cache_store(Monitor *monitor, LayoutCache *cache,
+					uint64_t key)
+{
+	Client *c = NULL;
+
+	cache->size = 0;
+	for (c = Client__next_tiled(monitor->client_list); c;
+	     c = Client__next_tiled(c->next)) {
+		if (cache->size == cache->capacity) {
+			cache->capacity = cache->capacity ? cache->capacity * 2 :
+							    16;
+			cache->entries = realloc(cache->entries,
+						 cache->capacity *
+							 sizeof(LayoutCacheEntry));
+			if (!cache->entries) {
+				die("realloc:");
+			}
+		}
+		cache->entries[cache->size++] = (LayoutCacheEntry){
+			.client = c, .x = c->x, .y = c->y, .w = c->w, .h = c->h
+		};
+	}
+
+	strncpy(cache->layout_symbol, monitor->layout_symbol,
+		sizeof(cache->layout_symbol));
+	cache->key = key;
+	cache->valid = true;
+}
+
+uint32_t Monitor__tag_index(uint32_t tagset)
+{
+	uint32_t i = 0;
+
+	if ((tagset & TAGMASK) == TAGMASK) {
+		return 0;
+	}
+	for (i = 0; i < LENGTH(G_TAGS) && !(tagset & 1 << i); ++i) {
+		;
+	}
+	return i < LENGTH(G_TAGS) ? i + 1 : 0;
+}
+
+void Monitor__save_tag_state(Monitor *monitor)
+{
+	TagState *ts = &monitor->tag_state[monitor->current_tag];
+
+	ts->master_width_factor = monitor->master_width_factor;
+	ts->num_master = monitor->num_master;
+	ts->selected_layout = monitor->selected_layout;
+	memcpy(ts->layouts, monitor->layouts, sizeof(ts->layouts));
+	ts->selected_client = monitor->selected_client;
+}
+
+Client *Monitor__load_tag_state(Monitor *monitor)
 {
+	TagState *ts = &monitor->tag_state[monitor->current_tag];
+
+	monitor->master_width_factor = ts->master_width_factor;
+	monitor->num_master = ts->num_master;
+	monitor->selected_layout = ts->selected_layout;
+	memcpy(monitor->layouts, ts->layouts, sizeof(monitor->layouts));
 	strncpy(monitor->layout_symbol,
 		monitor->layouts[monitor->selected_layout]->symbol,
 		sizeof(monitor->layout_symbol));
+	return ts->selected_client;
+}
+
+Client *Monitor__view(Monitor *monitor, uint32_t tags)
+{
+	uint32_t tag = 0;
+	Client *client = NULL;
 
-	if (monitor->layouts[monitor->selected_layout]->handler) {
-		monitor->layouts[monitor->selected_layout]->handler(monitor);
+	Monitor__save_tag_state(monitor);
+
+	// Toggle the selected tag set
+	monitor->selected_tags ^= 1;
+	if (tags & TAGMASK) {
+		monitor->tag_set[monitor->selected_tags] = tags & TAGMASK;
+		monitor->previous_tag = monitor->current_tag;
+		monitor->current_tag = Monitor__tag_index(tags);
+	} else {
+		tag = monitor->previous_tag;
+		monitor->previous_tag = monitor->current_tag;
+		monitor->current_tag = tag;
 	}
+
+	// Restore the layout and focus this tag was left with
+	client = Monitor__load_tag_state(monitor);
+	Monitor__arrange(monitor);
+
+	// Nothing in view, don't walk the clients on other tags
+	if (!client || !ISVISIBLE(client)) {
+		for (client = Monitor__get_num_clients(monitor) ?
+				      monitor->client_stack :
+				      NULL;
+		     client && !ISVISIBLE(client); client = client->stack_next) {
+			;
+		}
+	}
+	return client;
+}
+
+void Monitor__forget_client(Monitor *monitor, Client *client)
+{
+	TagState *ts = NULL;
+
+	for (uint32_t i = 0; i < LENGTH(monitor->tag_state); ++i) {
+		ts = &monitor->tag_state[i];
+		if (ts->selected_client == client) {
+			ts->selected_client = NULL;
+		}
+		for (uint32_t j = 0; ts->cache.valid && j < ts->cache.size;
+		     ++j) {
+			if (ts->cache.entries[j].client == client) {
+				ts->cache.valid = false;
+			}
+		}
+	}
+}
+
+void Monitor__arrange(Monitor *monitor)
+{
+	const Layout *layout = monitor->layouts[monitor->selected_layout];
+	LayoutCache *cache = &monitor->tag_state[monitor->current_tag].cache;
+	uint64_t key = 0;
+
+	strncpy(monitor->layout_symbol, layout->symbol,
+		sizeof(monitor->layout_symbol));
+
+	if (!layout->handler) {
+		cache->valid = false;
+		return;
+	}
+
+	// Nothing the layout depends on changed since it last ran on this tag,
+	// so every client is already where the handler would put it.
+	key = Monitor__layout_key(monitor);
+	if (cache->valid && cache->key == key &&
+	    Monitor__layout_cache_matches(monitor, cache)) {
+		strncpy(monitor->layout_symbol, cache->layout_symbol,
+			sizeof(monitor->layout_symbol));
+		return;
+	}
+
+	layout->handler(monitor);
+	Monitor__layout_cache_store(monitor, cache, key);
+}
+
+void Monitor__prepare_hidden_tags(Monitor *monitor)
+{
+	char layout_symbol[MAX_LAYOUT_SYMBOL_LEN];
+	const uint32_t visible = monitor->tag_set[monitor->selected_tags];
+	const uint32_t current_tag = monitor->current_tag;
+	uint32_t on_screen = 0;
+	Client *c = NULL;
+
+	// Tags in view are arranged as usual, without tiled clients the
+	// layout has nothing to place
+	monitor->hidden_tags_dirty &= monitor->tiled_tags & ~visible;
+	if (!monitor->hidden_tags_dirty) {
+		return;
+	}
+
+	for (c = monitor->client_list; c; c = c->next) {
+		if (!c->hidden) {
+			on_screen |= c->tags;
+		}
+	}
+	if (!(monitor->hidden_tags_dirty & ~on_screen)) {
+		return;
+	}
+
+	Monitor__save_tag_state(monitor);
+	strncpy(layout_symbol, monitor->layout_symbol, sizeof(layout_symbol));
+
+	for (uint32_t i = 0; i < LENGTH(G_TAGS); ++i) {
+		// Tags sharing a client with the screen stay marked for later
+		if (!(monitor->hidden_tags_dirty & 1 << i) ||
+		    on_screen & 1 << i) {
+			continue;
+		}
+
+		// Give the pending events priority, we will be back when idle
+		if (XPending(g_swm.ctx.xconn)) {
+			break;
+		}
+		monitor->hidden_tags_dirty &= ~(1 << i);
+
+		// Pretend the tag is in view, the layout cache turns this into
+		// a no-op for tags which are already prepared.
+		monitor->tag_set[monitor->selected_tags] = 1 << i;
+		monitor->current_tag = i + 1;
+		Monitor__load_tag_state(monitor);
+		Monitor__arrange(monitor);
+	}
+
+	monitor->tag_set[monitor->selected_tags] = visible;
+	monitor->current_tag = current_tag;
+	Monitor__load_tag_state(monitor);
+	strncpy(monitor->layout_symbol, layout_symbol,
+		sizeof(monitor->layout_symbol));
 }
 
 bool Monitor__is_layout_monocle(Monitor *monitor)
@@ -60,17 +339,80 @@ bool Monitor__is_layout_monocle(Monitor *monitor)
 	       Monitor__layout_monocle;
 }
 
-int32_t Monitor__get_num_clients(Monitor *monitor)
+/// @brief Sets or clears bit `tag` of a mask depending on a count.
+static void Monitor__update_tag_mask(uint32_t *mask, uint32_t tag,
+				     uint32_t count)
 {
-	uint32_t n = 0;
+	*mask = count ? (*mask | 1 << tag) : (*mask & ~(1 << tag));
+}
+
+void Monitor__count_client(Monitor *monitor, const Client *client,
+			   int32_t delta)
+{
+	for (uint32_t i = 0; i < LENGTH(G_TAGS); ++i) {
+		if (!(client->tags & 1 << i)) {
+			continue;
+		}
+
+		monitor->tag_clients[i] += delta;
+		if (!client->isfloating) {
+			monitor->tag_tiled[i] += delta;
+		}
+		if (client->isurgent) {
+			monitor->tag_urgent[i] += delta;
+		}
+		Monitor__update_tag_mask(&monitor->occupied_tags, i,
+					 monitor->tag_clients[i]);
+		Monitor__update_tag_mask(&monitor->tiled_tags, i,
+					 monitor->tag_tiled[i]);
+		Monitor__update_tag_mask(&monitor->urgent_tags, i,
+					 monitor->tag_urgent[i]);
+	}
+	// The clients of these tags or their order changed
+	monitor->hidden_tags_dirty |= client->tags & TAGMASK;
+
+	if (client->tags & monitor->counted_view) {
+		monitor->num_visible += delta;
+		if (!client->isfloating) {
+			monitor->num_tiled += delta;
+		}
+	}
+}
+
+/// @brief Recounts the visible clients when the view changed since.
+///
+/// @details The view changes in many places, `Swm__view`, `Swm__toggleview`
+/// and the hidden tag preparation among them, so the counts follow it
+/// lazily instead of being updated by each of them.
+static void Monitor__count_view(Monitor *monitor)
+{
+	const uint32_t view = monitor->tag_set[monitor->selected_tags];
 	Client *c = NULL;
-	// collect number of visible clients on this monitor.
+
+	if (monitor->counted_view == view) {
+		return;
+	}
+
+	monitor->counted_view = view;
+	monitor->num_visible = monitor->num_tiled = 0;
 	for (c = monitor->client_list; c; c = c->next) {
-		if (ISVISIBLE(c)) {
-			n++;
+		if (c->tags & view) {
+			monitor->num_visible += 1;
+			monitor->num_tiled += !c->isfloating;
 		}
 	}
-	return n;
+}
+
+int32_t Monitor__get_num_clients(Monitor *monitor)
+{
+	Monitor__count_view(monitor);
+	return monitor->num_visible;
+}
+
+int32_t Monitor__get_num_tiled(Monitor *monitor)
+{
+	Monitor__count_view(monitor);
+	return monitor->num_tiled;
 }
 
 void Monitor__layout_monocle(Monitor *monitor)
@@ -102,13 +444,8 @@ void Monitor__layout_master_stack(Monitor *mon)
 	uint32_t tiled_y = 0;
 	Client *c = NULL;
 
-	// Check to see if we have any tiled clients on this monitor.
-	for (num_tiled_clients = 0, c = Client__next_tiled(mon->client_list); c;
-	     c = Client__next_tiled(c->next), ++num_tiled_clients) {
-		;
-	}
 	// If we have no tiled clients, we have nothing to do.
-	if (num_tiled_clients == 0) {
+	if ((num_tiled_clients = Monitor__get_num_tiled(mon)) == 0) {
 		return;
 	}
 
@@ -156,17 +493,21 @@ void Monitor__layout_master_stack(Monitor *mon)
 
 void Monitor__updatebarpos(Monitor *monitor)
 {
+	// The work area of every tag changes
+	monitor->hidden_tags_dirty = TAGMASK;
+
 	// TODO: Refactor: Could be moved into a new Bar stucture
 	monitor->wy = monitor->my;
 	monitor->wh = monitor->mh;
 	if (monitor->show_bar) {
-		monitor->wh -= g_swm.bar_height;
+		monitor->wh -= monitor->bar_scale->bar_height;
 		monitor->bar_y = monitor->top_bar ? monitor->wy :
 						    monitor->wy + monitor->wh;
 		monitor->wy = monitor->top_bar ?
-				      monitor->wy + g_swm.bar_height :
+				      monitor->wy +
+					      monitor->bar_scale->bar_height :
 				      monitor->wy;
 	} else {
-		monitor->bar_y = -g_swm.bar_height;
+		monitor->bar_y = -monitor->bar_scale->bar_height;
 	}
 }
@@ -11,8 +11,10 @@
 #include <stdbool.h>
 
 // Slacker Headers
+#include "barscale.h"
 #include "constants.h"
 #include "client.h"
+#include "drawable.h"
 
 typedef struct Layout Layout;
 typedef void (*LayoutHandler)(Monitor *);
@@ -30,6 +32,48 @@ struct Layout {
 	(MAX(0, MIN((x) + (w), (m)->wx + (m)->ww) - MAX((x), (m)->wx)) * \
 	 MAX(0, MIN((y) + (h), (m)->wy + (m)->wh) - MAX((y), (m)->wy)))
 
+/// @brief Geometry of one tiled client, as left behind by a layout run
+typedef struct LayoutCacheEntry LayoutCacheEntry;
+struct LayoutCacheEntry {
+	Client *client;
+	int32_t x, y, w, h;
+};
+
+/// @brief The last layout computed for a tag.
+///
+/// @details Reused as long as the inputs of the layout handler hash to the
+/// same key and every client still sits where the handler put it.
+typedef struct LayoutCache LayoutCache;
+struct LayoutCache {
+	/// Hash of everything the layout handler reads
+	uint64_t key;
+	/// The entries describe a finished layout run
+	bool valid;
+	/// Layout symbol as written by the handler, monocle shows a client count
+	char layout_symbol[MAX_LAYOUT_SYMBOL_LEN];
+	/// Number of used and allocated entries
+	uint32_t size, capacity;
+	/// Tiled clients in layout order
+	LayoutCacheEntry *entries;
+};
+
+/// @brief Layout state which is remembered per tag
+typedef struct TagState TagState;
+struct TagState {
+	/// Master width factor of this tag
+	float master_width_factor;
+	/// Number of windows in the master area of this tag
+	int32_t num_master;
+	/// Selected layout of this tag
+	uint32_t selected_layout;
+	/// Layouts of this tag
+	const Layout *layouts[MAX_LAYOUTS];
+	/// Client that was focused when the tag was left
+	Client *selected_client;
+	/// Geometry of the last layout run on this tag
+	LayoutCache cache;
+};
+
 /// @brief Represents a physical monitor
 struct Monitor {
 	/// Layout symbol thats displayed in the bar
@@ -66,8 +110,45 @@ struct Monitor {
 	Monitor *next;
 	/// Xid for the bar window
 	Window bar_win_id;
+	/// Bar scale factor from the DPI of the monitor, 1 is 96 DPI
+	double scale;
+	/// Fonts and measurements of the bar, shared by monitors of one scale
+	BarScale *bar_scale;
+	/// Back buffer of the bar
+	Drw *draw;
+	/// Xid of the input only window below all clients covering the
+	/// monitor, entering it reports the pointer moving to this monitor
+	Window backdrop_win_id;
 	/// Layouts
 	const Layout *layouts[MAX_LAYOUTS];
+	/// Tags whose layout inputs changed since they were last prepared,
+	/// marked by `Monitor__count_client` and `Monitor__updatebarpos`
+	uint32_t hidden_tags_dirty;
+	/// Number of clients on each tag, all of them, the tiled and the
+	/// urgent ones, see `Monitor__count_client`
+	uint32_t tag_clients[MAX_TAGS];
+	uint32_t tag_tiled[MAX_TAGS];
+	uint32_t tag_urgent[MAX_TAGS];
+	/// Tags with at least one client, tiled client and urgent client
+	uint32_t occupied_tags, tiled_tags, urgent_tags;
+	/// Tag set the visible counts were taken for, recounted when the view
+	/// changed since
+	uint32_t counted_view;
+	/// Number of clients and tiled clients in counted_view
+	uint32_t num_visible, num_tiled;
+	/// Microseconds per frame of the output showing the monitor, 0 until
+	/// looked up, see `Swm__schedule_drawbar`
+	uint64_t frame_us;
+	/// Monotonic time in microseconds of the last bar redraw
+	uint64_t bar_drawn_us;
+	/// When a deferred title change has to be drawn, 0 if none
+	uint64_t bar_redraw_us;
+	/// Index into tag_state of the tag being viewed, 0 means all tags
+	uint32_t current_tag;
+	/// Index into tag_state of the previously viewed tag
+	uint32_t previous_tag;
+	/// Per tag layout state, index 0 is used when viewing all tags
+	TagState tag_state[MAX_TAGS + 1];
 };
 
 /// @brief Constructs a single monitor
@@ -78,16 +159,79 @@ Monitor *Monitor__new(void);
 /// @details Also unmaps the bar window and destroys it.
 void Monitor__delete(Monitor *monitor);
 
+/// @brief A reference to the monitor which can be kept across events.
+///
+/// @returns The handle, see pool.h
+uint32_t Monitor__handle(const Monitor *monitor);
+
+/// @brief Looks up a monitor by its handle.
+///
+/// @returns The monitor, NULL if it was removed since
+Monitor *Monitor__from_handle(uint32_t handle);
+
+/// @brief Maps a tag set to its index into `Monitor::tag_state`.
+///
+/// @details All tags map to 0, any other set maps to its lowest tag + 1.
+uint32_t Monitor__tag_index(uint32_t tagset);
+
+/// @brief Stores the active layout state of a monitor into its current tag.
+void Monitor__save_tag_state(Monitor *monitor);
+
+/// @brief Loads the layout state of the current tag into the monitor.
+///
+/// @returns The client which was focused when the tag was left, may be NULL.
+Client *Monitor__load_tag_state(Monitor *monitor);
+
+/// @brief Switches the tags in view, the part of `Swm__view` which doesn't
+/// talk to the server.
+///
+/// @details Swaps the tag state, arranges the monitor, which is a cache hit
+/// for a tag that didn't change since it was last in view, and picks the
+/// client to focus. Showing, hiding and focusing are left to the caller.
+///
+/// @param `tags` The tags to view, 0 for the previous tag
+///
+/// @returns The client to focus, NULL if no client is in view
+Client *Monitor__view(Monitor *monitor, uint32_t tags);
+
+/// @brief Drops every per tag reference to a client which is leaving this monitor.
+void Monitor__forget_client(Monitor *monitor, Client *client);
+
+/// @brief Lays out the hidden tags of a monitor ahead of time.
+///
+/// @details Clients on hidden tags are resized while they are still parked
+/// off screen, so they can repaint at their final size before they are shown
+/// and a later tag switch only has to move them. Tags which share a client
+/// with the tags in view are skipped. Only tags marked in
+/// `Monitor::hidden_tags_dirty` are laid out. Yields between tags when X
+/// events are pending, the tags left over stay marked.
+void Monitor__prepare_hidden_tags(Monitor *monitor);
+
 /// @brief Checks if the layout is monocle mode
 bool Monitor__is_layout_monocle(Monitor *monitor);
 
 /// @brief Updates the layout symbol, then calls the layout's arrange function
 /// for the given monitor.
+///
+/// @details The handler is skipped when the cached layout of the current tag
+/// is still valid, see `LayoutCache`.
 void Monitor__arrange(Monitor *monitor);
 
+/// @brief Adds or removes a client from the per tag counts of a monitor.
+///
+/// @details Called with 1 when a client is attached to the client list and
+/// with -1 when it is detached, see `Client__attach`. Clients in the list
+/// change tags, floating or urgency through the `Client__set_*` functions,
+/// which take them out of the counts and put them back.
+void Monitor__count_client(Monitor *monitor, const Client *client,
+			   int32_t delta);
+
 /// @brief Get total number of clients on this monitor
 int32_t Monitor__get_num_clients(Monitor *monitor);
 
+/// @brief Get the number of visible tiled clients on this monitor
+int32_t Monitor__get_num_tiled(Monitor *monitor);
+
 /// @brief Update the status bar position for one monitor
 void Monitor__updatebarpos(Monitor *monitor);
 
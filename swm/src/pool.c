@@ -0,0 +1,169 @@
+// Standard Libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Slacker Headers
+#include "pool.h"
+#include "utils.h"
+
+#define POOL_INDEX_MASK ((1u << POOL_INDEX_BITS) - 1)
+#define POOL_GENERATION_MASK ((1u << (32 - POOL_INDEX_BITS)) - 1)
+
+static PoolSlot *Pool__slot(const Pool *pool, uint32_t index)
+{
+	return (PoolSlot *)(pool->slabs[index / POOL_SLAB_ITEMS] +
+			    (index % POOL_SLAB_ITEMS) * pool->stride +
+			    pool->header_offset);
+}
+
+/// @brief The object stored in front of a slot header.
+static void *Pool__item(const Pool *pool, PoolSlot *slot)
+{
+	return (char *)slot - pool->header_offset;
+}
+
+/// @brief The slot header behind an object.
+static PoolSlot *Pool__header(const Pool *pool, const void *item)
+{
+	return (PoolSlot *)((char *)item + pool->header_offset);
+}
+
+/// @brief Adds one slab and puts its slots on the free list.
+static void Pool__grow(Pool *pool)
+{
+	uint32_t first = pool->num_slabs * POOL_SLAB_ITEMS;
+	PoolSlot *slot = NULL;
+	void *slab = NULL;
+
+	if (first + POOL_SLAB_ITEMS > POOL_INDEX_MASK + 1) {
+		die("%s pool: more than %u objects", pool->name,
+		    POOL_INDEX_MASK + 1);
+	}
+
+	// The slab table grows by doubling, so it is only realloc'd once
+	// every power of two slabs
+	if (!(pool->num_slabs & (pool->num_slabs - 1))) {
+		pool->slabs = realloc(pool->slabs,
+				      MAX(pool->num_slabs * 2, 1) *
+					      sizeof(char *));
+		if (!pool->slabs) {
+			die("realloc:");
+		}
+		pool->mallocs += 1;
+	}
+	if (posix_memalign(&slab, CACHE_LINE_SIZE,
+			   POOL_SLAB_ITEMS * pool->stride)) {
+		die("posix_memalign:");
+	}
+	memset(slab, 0, POOL_SLAB_ITEMS * pool->stride);
+	pool->slabs[pool->num_slabs++] = slab;
+	pool->mallocs += 1;
+
+	// Pushed in reverse, so the slab is handed out front to back
+	for (uint32_t i = POOL_SLAB_ITEMS; i-- > 0;) {
+		slot = Pool__slot(pool, first + i);
+		slot->index = first + i;
+		slot->generation = 0;
+		slot->next_free = pool->free_list;
+		pool->free_list = slot;
+	}
+}
+
+void Pool__init(Pool *pool, const char *name, size_t item_size)
+{
+	memset(pool, 0, sizeof(Pool));
+	pool->name = name;
+	pool->item_size = item_size;
+	// Objects start on a cache line, the header follows them
+	pool->header_offset = (item_size + sizeof(void *) - 1) /
+			      sizeof(void *) * sizeof(void *);
+	pool->stride = (pool->header_offset + sizeof(PoolSlot) +
+			CACHE_LINE_SIZE - 1) /
+		       CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+}
+
+void *Pool__alloc(Pool *pool)
+{
+	PoolSlot *slot = NULL;
+	void *item = NULL;
+
+	if (!pool->free_list) {
+		Pool__grow(pool);
+	}
+
+	slot = pool->free_list;
+	pool->free_list = slot->next_free;
+	slot->next_free = NULL;
+	slot->generation = (slot->generation + 1) & POOL_GENERATION_MASK;
+
+	item = Pool__item(pool, slot);
+	memset(item, 0, pool->item_size);
+	pool->allocs += 1;
+	pool->live += 1;
+	pool->peak = MAX(pool->peak, pool->live);
+	return item;
+}
+
+void Pool__free(Pool *pool, void *item)
+{
+	PoolSlot *slot = NULL;
+
+	if (!item) {
+		return;
+	}
+
+	slot = Pool__header(pool, item);
+	// Even again, the handles of the object no longer match
+	slot->generation = (slot->generation + 1) & POOL_GENERATION_MASK;
+	slot->next_free = pool->free_list;
+	pool->free_list = slot;
+	pool->frees += 1;
+	pool->live -= 1;
+}
+
+uint32_t Pool__handle(const Pool *pool, const void *item)
+{
+	const PoolSlot *slot = Pool__header(pool, item);
+
+	return (slot->generation << POOL_INDEX_BITS) | slot->index;
+}
+
+void *Pool__get(const Pool *pool, uint32_t handle)
+{
+	uint32_t index = handle & POOL_INDEX_MASK;
+	PoolSlot *slot = NULL;
+
+	if (!handle || index >= pool->num_slabs * POOL_SLAB_ITEMS) {
+		return NULL;
+	}
+
+	// Handles are only made of odd generations, so a free slot with a
+	// matching one can't exist
+	slot = Pool__slot(pool, index);
+	if (slot->generation != handle >> POOL_INDEX_BITS) {
+		return NULL;
+	}
+	return Pool__item(pool, slot);
+}
+
+void Pool__log(const Pool *pool)
+{
+	fprintf(stdout,
+		"%s pool: %llu allocs, %llu frees, %u live, %u peak, "
+		"%llu mallocs for %u slabs\n",
+		pool->name, (unsigned long long)pool->allocs,
+		(unsigned long long)pool->frees, pool->live, pool->peak,
+		(unsigned long long)pool->mallocs, pool->num_slabs);
+}
+
+void Pool__delete(Pool *pool)
+{
+	for (uint32_t i = 0; i < pool->num_slabs; ++i) {
+		free(pool->slabs[i]);
+	}
+	free(pool->slabs);
+	pool->slabs = NULL;
+	pool->num_slabs = 0;
+	pool->free_list = NULL;
+}
@@ -0,0 +1,84 @@
+#ifndef SWM_POOL_H
+#define SWM_POOL_H
+
+/// Fixed size object pool, used for the Client and Monitor structs.
+///
+/// Objects live in slabs of POOL_SLAB_ITEMS, each starting on a cache line,
+/// and freed ones are reused from a free list, so window churn doesn't call
+/// malloc once the pool has grown to the session's peak. Every slot carries a generation which is
+/// bumped when it is handed out and when it is freed, a handle combines it
+/// with the slot index so code which keeps a reference across events can
+/// tell when the object is gone.
+
+// Standard Libraries
+#include <stddef.h>
+#include <stdint.h>
+
+// Slacker Headers
+#include "constants.h"
+
+typedef struct Pool Pool;
+typedef struct PoolSlot PoolSlot;
+
+/// @brief Header behind every object in a slab
+struct PoolSlot {
+	/// Position of the slot in the pool, the low bits of its handle
+	uint32_t index;
+	/// Bumped on every alloc and free, odd while the object is in use
+	uint32_t generation;
+	/// Next free slot while the slot is on the free list
+	PoolSlot *next_free;
+};
+
+struct Pool {
+	/// Name used when logging
+	const char *name;
+	/// Distance between two slots in a slab, header included, a multiple
+	/// of CACHE_LINE_SIZE
+	size_t stride;
+	/// Position of the header behind each object
+	size_t header_offset;
+	/// Size of the objects
+	size_t item_size;
+	/// The slabs, each holds POOL_SLAB_ITEMS slots
+	char **slabs;
+	uint32_t num_slabs;
+	/// Most recently freed slot first
+	PoolSlot *free_list;
+	/// Objects handed out and returned, slabs and slab tables malloc'd
+	uint64_t allocs, frees, mallocs;
+	/// Objects in use now and at most
+	uint32_t live, peak;
+};
+
+/// @brief Sets up an empty pool, nothing is allocated until the first
+/// `Pool__alloc`.
+///
+/// @param `name` Used when logging
+/// @param `item_size` sizeof the objects
+void Pool__init(Pool *pool, const char *name, size_t item_size);
+
+/// @brief Hands out a zeroed object, dies if memory runs out.
+void *Pool__alloc(Pool *pool);
+
+/// @brief Returns an object to the pool, its handles turn stale.
+void Pool__free(Pool *pool, void *item);
+
+/// @brief A reference to an object which survives it being freed.
+///
+/// @returns The handle, never 0 since the generation of an object in use is
+/// odd
+uint32_t Pool__handle(const Pool *pool, const void *item);
+
+/// @brief Looks up the object behind a handle.
+///
+/// @returns The object, NULL if the handle is 0 or the object was freed
+void *Pool__get(const Pool *pool, uint32_t handle);
+
+/// @brief Prints the allocation counts to stdout.
+void Pool__log(const Pool *pool);
+
+/// @brief Frees all slabs, every object of the pool has to be freed first.
+void Pool__delete(Pool *pool);
+
+#endif
@@ -0,0 +1,215 @@
+// X11 Libraries
+#include <X11/Xlib.h>
+#ifdef XRANDR
+#include <X11/extensions/Xrandr.h>
+#endif
+#ifdef XINERAMA
+#include <X11/extensions/Xinerama.h>
+#endif
+
+// Slacker Headers
+#include "constants.h"
+#include "randr.h"
+#include "swm.h"
+#include "utils.h"
+
+void Randr__init(void)
+{
+#ifdef XRANDR
+	int32_t error_base = 0;
+
+	int32_t major = 0;
+	int32_t minor = 0;
+
+	g_swm.has_randr = XRRQueryExtension(g_swm.ctx.xconn,
+					    &g_swm.randr_event_base,
+					    &error_base);
+
+	// Output hotplug and mode changes, see `Randr__handle_event`
+	if (g_swm.has_randr) {
+		XRRSelectInput(g_swm.ctx.xconn, g_swm.ctx.xroot_id,
+			       RRScreenChangeNotifyMask |
+				       RRCrtcChangeNotifyMask |
+				       RROutputChangeNotifyMask);
+	}
+
+	// RRGetMonitors came with RandR 1.5
+	g_swm.has_randr_monitors =
+		g_swm.has_randr &&
+		XRRQueryVersion(g_swm.ctx.xconn, &major, &minor) &&
+		(major > 1 || (major == 1 && minor >= 5));
+#else
+	g_swm.has_randr = false;
+	g_swm.has_randr_monitors = false;
+#endif
+}
+
+bool Randr__handle_event(XEvent *event)
+{
+#ifdef XRANDR
+	if (!g_swm.has_randr) {
+		return false;
+	}
+
+	if (event->type == g_swm.randr_event_base + RRScreenChangeNotify) {
+		XRRUpdateConfiguration(event);
+	} else if (event->type != g_swm.randr_event_base + RRNotify) {
+		return false;
+	}
+
+	Swm__schedule_monitor_update();
+	return true;
+#else
+	return false;
+#endif
+}
+
+/// @brief Derives the bar scale from the DPI of a monitor.
+///
+/// @details Rounded to quarter steps and kept within [1, MAX_BAR_SCALE], a
+/// missing or bogus physical size reads as a regular 96 DPI monitor.
+///
+/// @param `pixels` Width in pixels
+/// @param `mm` Physical width in millimeters, 0 if unknown
+static double Randr__scale(int32_t pixels, int32_t mm)
+{
+	double scale = 1;
+
+	if (mm > 0) {
+		scale = (int32_t)((pixels * 25.4 / mm) / 96 * 4 + 0.5) / 4.0;
+	}
+	return MIN(MAX(scale, 1), MAX_BAR_SCALE);
+}
+
+/// @brief Appends a geometry unless an identical one is already listed.
+///
+/// @details Cloned outputs show up as several monitors with the same
+/// geometry, they are managed as one.
+static void Randr__add_unique(MonitorGeometry *geoms, int32_t *count,
+			      int32_t x, int32_t y, int32_t w, int32_t h,
+			      double scale)
+{
+	for (int32_t i = 0; i < *count; ++i) {
+		if (geoms[i].x == x && geoms[i].y == y && geoms[i].w == w &&
+		    geoms[i].h == h) {
+			return;
+		}
+	}
+
+	geoms[*count] = (MonitorGeometry){ x, y, w, h, scale };
+	++*count;
+}
+
+int32_t Randr__monitor_geometries(MonitorGeometry **geoms)
+{
+	int32_t count = 0;
+	// Physical size of the whole screen, used when a monitor has none
+	double screen_scale = Randr__scale(
+		g_swm.ctx.xscreen_width,
+		DisplayWidthMM(g_swm.ctx.xconn, g_swm.ctx.xscreen_id));
+#ifdef XRANDR
+	XRRMonitorInfo *monitors = NULL;
+	int32_t n = 0;
+
+	if (g_swm.has_randr_monitors &&
+	    (monitors = XRRGetMonitors(g_swm.ctx.xconn, g_swm.ctx.xroot_id,
+				       True, &n))) {
+		*geoms = ecalloc(MAX(n, 1), sizeof(MonitorGeometry));
+		for (int32_t i = 0; i < n; ++i) {
+			Randr__add_unique(*geoms, &count, monitors[i].x,
+					  monitors[i].y, monitors[i].width,
+					  monitors[i].height,
+					  Randr__scale(monitors[i].width,
+						       monitors[i].mwidth));
+		}
+		XRRFreeMonitors(monitors);
+		if (count) {
+			return count;
+		}
+		free(*geoms);
+	}
+#endif
+#ifdef XINERAMA
+	XineramaScreenInfo *screens = NULL;
+	int32_t nscreens = 0;
+
+	// Xinerama knows no physical sizes
+	if (XineramaIsActive(g_swm.ctx.xconn) &&
+	    (screens = XineramaQueryScreens(g_swm.ctx.xconn, &nscreens))) {
+		*geoms = ecalloc(MAX(nscreens, 1), sizeof(MonitorGeometry));
+		for (int32_t i = 0; i < nscreens; ++i) {
+			Randr__add_unique(*geoms, &count, screens[i].x_org,
+					  screens[i].y_org, screens[i].width,
+					  screens[i].height, 1);
+		}
+		XFree(screens);
+		if (count) {
+			return count;
+		}
+		free(*geoms);
+	}
+#endif
+
+	// A single monitor covering the whole screen
+	*geoms = ecalloc(1, sizeof(MonitorGeometry));
+	Randr__add_unique(*geoms, &count, 0, 0, g_swm.ctx.xscreen_width,
+			  g_swm.ctx.xscreen_height, screen_scale);
+	return count;
+}
+
+#ifdef XRANDR
+/// @brief Computes the vertical refresh rate of a mode in Hz, 0 if unknown.
+static double Randr__mode_refresh_rate(const XRRModeInfo *mode)
+{
+	double vtotal = mode->vTotal;
+
+	if (mode->modeFlags & RR_DoubleScan) {
+		vtotal *= 2;
+	}
+	if (mode->modeFlags & RR_Interlace) {
+		vtotal /= 2;
+	}
+
+	if (!mode->hTotal || !vtotal) {
+		return 0;
+	}
+	return (double)mode->dotClock / (mode->hTotal * vtotal);
+}
+#endif
+
+double Randr__refresh_rate_at(int32_t x, int32_t y)
+{
+	double rate = 0;
+#ifdef XRANDR
+	XRRScreenResources *res = NULL;
+	XRRCrtcInfo *crtc = NULL;
+
+	if (!g_swm.has_randr ||
+	    !(res = XRRGetScreenResourcesCurrent(g_swm.ctx.xconn,
+						 g_swm.ctx.xroot_id))) {
+		return DEFAULT_REFRESH_RATE;
+	}
+
+	for (int32_t i = 0; i < res->ncrtc && rate <= 0; ++i) {
+		if (!(crtc = XRRGetCrtcInfo(g_swm.ctx.xconn, res,
+					    res->crtcs[i]))) {
+			continue;
+		}
+
+		if (crtc->mode != None && x >= crtc->x &&
+		    x < crtc->x + (int32_t)crtc->width && y >= crtc->y &&
+		    y < crtc->y + (int32_t)crtc->height) {
+			for (int32_t j = 0; j < res->nmode; ++j) {
+				if (res->modes[j].id == crtc->mode) {
+					rate = Randr__mode_refresh_rate(
+						&res->modes[j]);
+					break;
+				}
+			}
+		}
+		XRRFreeCrtcInfo(crtc);
+	}
+	XRRFreeScreenResources(res);
+#endif
+	return rate > 0 ? rate : DEFAULT_REFRESH_RATE;
+}
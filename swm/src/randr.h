@@ -0,0 +1,57 @@
+#ifndef SWM_RANDR_H
+#define SWM_RANDR_H
+
+/// Optional RandR support, compiled in when XRANDR is defined.
+/// Without it every query falls back to a sane default.
+
+// X11 Libraries
+#include <X11/Xlib.h>
+
+// Standard Libraries
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct MonitorGeometry MonitorGeometry;
+
+/// @brief Geometry and bar scale of one physical monitor
+struct MonitorGeometry {
+	int32_t x, y, w, h;
+	/// Bar scale derived from the DPI, 1 is 96 DPI
+	double scale;
+};
+
+/// @brief Queries the RandR extension and remembers if it can be used.
+///
+/// @details Called once in `Swm__startup`.
+void Randr__init(void);
+
+/// @brief Handles RRScreenChangeNotify and RRNotify events.
+///
+/// @details Output changes come in bursts, they only schedule a monitor
+/// update, see `Swm__schedule_monitor_update`.
+///
+/// @returns true if the event was a RandR event
+bool Randr__handle_event(XEvent *event);
+
+/// @brief Lists the geometries of the physical monitors.
+///
+/// @details Asks RandR 1.5 for its monitors, then Xinerama (when built with
+/// XINERAMA) for its screens, and otherwise reports the whole X screen as a
+/// single monitor. Identical geometries are only listed once. The scale
+/// comes from the physical size RandR reports, Xinerama monitors are
+/// unscaled.
+///
+/// @param `geoms` Set to an array the caller has to free
+///
+/// @returns The number of geometries, at least 1
+int32_t Randr__monitor_geometries(MonitorGeometry **geoms);
+
+/// @brief Looks up the refresh rate of the output showing a point on the root window.
+///
+/// @param `x` Root x coordinate
+/// @param `y` Root y coordinate
+///
+/// @returns The refresh rate in Hz, DEFAULT_REFRESH_RATE if unknown
+double Randr__refresh_rate_at(int32_t x, int32_t y);
+
+#endif
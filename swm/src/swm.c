@@ -5,27 +5,34 @@
 #include <X11/Xproto.h>
 #include <X11/Xutil.h>
 #include <X11/cursorfont.h>
+#include <X11/extensions/sync.h>
 #include <X11/keysym.h>
 
 // Standard libraries
+#include <fcntl.h>
 #include <locale.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/select.h>
 #include <sys/types.h>
 #include <unistd.h>
 
 // Slacker headers
+#include "barscale.h"
 #include "client.h"
 #include "config.h"
 #include "common.h"
 #include "error.h"
 #include "events.h"
 #include "swm.h"
+#include "timing.h"
 #include "utils.h"
 #include "modifiers.h"
 #include "monitor.h"
+#include "randr.h"
 
 Swm g_swm;
 
@@ -51,6 +58,8 @@ Ctx Ctx__new(void)
 	if (!(ctx.xconn = XOpenDisplay(NULL))) {
 		die("swm: cannot open display");
 	}
+	// Keep the connection out of the programs we spawn
+	fcntl(ConnectionNumber(ctx.xconn), F_SETFD, FD_CLOEXEC);
 
 	ctx.xscreen_id = DefaultScreen(ctx.xconn);
 	ctx.xscreen_width = DisplayWidth(ctx.xconn, ctx.xscreen_id);
@@ -105,8 +114,6 @@ static void Swm__checkotherwm(void)
 static void Swm__init(void)
 {
 	g_swm.ctx = Ctx__new();
-	g_swm.bar_height = 0;
-	g_swm.left_right_padding_sum = 0;
 	g_swm.xerror_callback = NULL;
 	g_swm.numlockmask = 0;
 	g_swm.is_running = false;
@@ -115,6 +122,21 @@ static void Swm__init(void)
 	}
 	g_swm.scheme = NULL;
 	g_swm.draw = NULL;
+	g_swm.bar_scales = NULL;
+	g_swm.has_sync = false;
+	g_swm.sync_event_base = 0;
+	g_swm.sync_error_base = 0;
+	g_swm.sync_opcode = 0;
+	g_swm.has_randr = false;
+	g_swm.randr_event_base = 0;
+	g_swm.has_randr_monitors = false;
+	g_swm.monitor_update_us = 0;
+	g_swm.drag.kind = SlackerDragKind_None;
+	g_swm.drag.client = 0;
+	g_swm.launches.pending_size = 0;
+	g_swm.launches.stats_size = 0;
+	Pool__init(&g_swm.client_pool, "client", sizeof(Client));
+	Pool__init(&g_swm.monitor_pool, "monitor", sizeof(Monitor));
 	g_swm.monitor_list = NULL;
 	g_swm.selected_monitor = NULL;
 }
@@ -169,75 +191,115 @@ static void Swm__scan(void)
 	}
 }
 
-/// @brief Initializes the draw object, fonts, and bar.
+/// @brief Loads the fontconfig configuration and caches.
 ///
-/// @details Private function, only called once in `Swm__init`
-static void Swm__init_fonts(void)
+/// @details Runs on a worker thread while the X setup goes on, it only
+/// touches fontconfig. Reading the caches is the slow part of opening the
+/// first font.
+static void *Swm__init_fontconfig(void *unused)
+{
+	if (!FcInit()) {
+		fprintf(stderr, "warning: fontconfig failed to initialize\n");
+	}
+	return NULL;
+}
+
+/// @brief Creates the draw object.
+///
+/// @details Private function, only called once in `Swm__init`. The bars draw
+/// into their own monitor's Drw, this one creates cursors and colors and
+/// measures texts, see barscale.h.
+static void Swm__init_draw(void)
 {
 	g_swm.draw = drw_create(g_swm.ctx.xconn, g_swm.ctx.xscreen_id,
-				g_swm.ctx.xroot_id, g_swm.ctx.xscreen_width,
-				g_swm.ctx.xscreen_height);
+				g_swm.ctx.xroot_id, 1, 1);
+}
 
-	if (!drw_fontset_create(g_swm.draw, G_USER_FONT)) {
+/// @brief Loads the unscaled fonts, once fontconfig is initialized.
+///
+/// @details Private function, only called once in `Swm__init`
+///
+/// @param `fontconfig` The thread running `Swm__init_fontconfig`
+static void Swm__init_fonts(pthread_t fontconfig)
+{
+	pthread_join(fontconfig, NULL);
+
+	if (!BarScale__get(1)) {
 		die("no fonts could be loaded.");
 	}
+}
+
+/// @brief Ends a phase of `Swm__startup`, debug builds print how long it took.
+///
+/// @param `name` The phase that just finished
+/// @param `phase_us` Start of the phase, set to the start of the next one
+static void Swm__startup_phase(const char *name, uint64_t *phase_us)
+{
+	uint64_t now_us = Timing__now_us();
 
-	// TODO: This will be moved to the future Bar struct
-	g_swm.left_right_padding_sum = g_swm.draw->fonts->h + 5;
-	g_swm.bar_height = g_swm.draw->fonts->h + 5;
+#if (DEBUG == true)
+	fprintf(stdout, "startup: %-12s %7.2f ms\n", name,
+		(now_us - *phase_us) / 1000.0);
+#else
+	(void)name;
+#endif
+	*phase_us = now_us;
 }
 
+/// Names of the ICCCM atoms, indexed by SlackerDefaultAtom
+static char *s_wm_atom_names[SlackerDefaultAtom_WMLast] = {
+	[SlackerDefaultAtom_WMProtocols] = "WM_PROTOCOLS",
+	[SlackerDefaultAtom_WMDelete] = "WM_DELETE_WINDOW",
+	[SlackerDefaultAtom_WMState] = "WM_STATE",
+	[SlackerDefaultAtom_WMTakeFocus] = "WM_TAKE_FOCUS",
+	[SlackerDefaultAtom_SwmLaunchStats] = "_SWM_LAUNCH_STATS",
+	[SlackerDefaultAtom_Utf8String] = "UTF8_STRING",
+};
+
+/// Names of the EWMH atoms, indexed by SlackerEWMHAtom
+static char *s_net_atom_names[SlackerEWMHAtom_NetLast] = {
+	[SlackerEWMHAtom_NetActiveWindow] = "_NET_ACTIVE_WINDOW",
+	[SlackerEWMHAtom_NetSupported] = "_NET_SUPPORTED",
+	[SlackerEWMHAtom_NetWMName] = "_NET_WM_NAME",
+	[SlackerEWMHAtom_NetWMState] = "_NET_WM_STATE",
+	[SlackerEWMHAtom_NetWMCheck] = "_NET_SUPPORTING_WM_CHECK",
+	[SlackerEWMHAtom_NetWMFullscreen] = "_NET_WM_STATE_FULLSCREEN",
+	[SlackerEWMHAtom_NetWMWindowType] = "_NET_WM_WINDOW_TYPE",
+	[SlackerEWMHAtom_NetWMWindowTypeDialog] = "_NET_WM_WINDOW_TYPE_DIALOG",
+	[SlackerEWMHAtom_NetClientList] = "_NET_CLIENT_LIST",
+	[SlackerEWMHAtom_NetWMSyncRequest] = "_NET_WM_SYNC_REQUEST",
+	[SlackerEWMHAtom_NetWMSyncRequestCounter] =
+		"_NET_WM_SYNC_REQUEST_COUNTER",
+	[SlackerEWMHAtom_NetWMPid] = "_NET_WM_PID",
+};
+
 /// @brief Sets up Wm atoms, and net atoms
 ///
-/// @details Private function, only called once in `Swm__init`
+/// @details Private function, only called once in `Swm__init`. All atoms are
+/// interned with one XInternAtoms call, which pipelines the requests and
+/// waits for the replies once.
 ///
-/// https://tronche.com/gui/x/xlib/window-information/XInternAtom.html
+/// https://tronche.com/gui/x/xlib/window-information/XInternAtoms.html
 ///
 /// @return Atom The UTF8_STRING atom
 Atom static Swm__init_atoms(void)
 {
-	Atom utf8string = XInternAtom(g_swm.ctx.xconn, "UTF8_STRING", False);
-
-	g_swm.wmatom[SlackerDefaultAtom_WMProtocols] =
-		XInternAtom(g_swm.ctx.xconn, "WM_PROTOCOLS", False);
-
-	g_swm.wmatom[SlackerDefaultAtom_WMDelete] =
-		XInternAtom(g_swm.ctx.xconn, "WM_DELETE_WINDOW", False);
+	char *names[SlackerDefaultAtom_WMLast + SlackerEWMHAtom_NetLast];
+	Atom atoms[LENGTH(names)];
 
-	g_swm.wmatom[SlackerDefaultAtom_WMState] =
-		XInternAtom(g_swm.ctx.xconn, "WM_STATE", False);
+	memcpy(names, s_wm_atom_names, sizeof(s_wm_atom_names));
+	memcpy(names + SlackerDefaultAtom_WMLast, s_net_atom_names,
+	       sizeof(s_net_atom_names));
 
-	g_swm.wmatom[SlackerDefaultAtom_WMTakeFocus] =
-		XInternAtom(g_swm.ctx.xconn, "WM_TAKE_FOCUS", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetActiveWindow] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_ACTIVE_WINDOW", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetSupported] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_SUPPORTED", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetWMName] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_WM_NAME", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetWMState] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_WM_STATE", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetWMCheck] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_SUPPORTING_WM_CHECK", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetWMFullscreen] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_WM_STATE_FULLSCREEN", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetWMWindowType] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_WM_WINDOW_TYPE", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetWMWindowTypeDialog] = XInternAtom(
-		g_swm.ctx.xconn, "_NET_WM_WINDOW_TYPE_DIALOG", False);
-
-	g_swm.netatom[SlackerEWMHAtom_NetClientList] =
-		XInternAtom(g_swm.ctx.xconn, "_NET_CLIENT_LIST", False);
+	if (!XInternAtoms(g_swm.ctx.xconn, names, LENGTH(names), False,
+			  atoms)) {
+		die("swm: cannot intern atoms");
+	}
 
-	return utf8string;
+	memcpy(g_swm.wmatom, atoms, sizeof(g_swm.wmatom));
+	memcpy(g_swm.netatom, atoms + SlackerDefaultAtom_WMLast,
+	       sizeof(g_swm.netatom));
+	return g_swm.wmatom[SlackerDefaultAtom_Utf8String];
 }
 
 /// @brief Initializes the supporting window for EWMH and set properties
@@ -267,6 +329,25 @@ static void Swm__init_ewmh_support(Atom utf8string)
 			g_swm.netatom[SlackerEWMHAtom_NetClientList]);
 }
 
+/// @brief Initializes the SYNC extension, used to pace interactive resizes.
+///
+/// @details Private function, only called once in `Swm__init`
+static void Swm__init_sync(void)
+{
+	int32_t error_base = 0;
+	int32_t major = 0;
+	int32_t minor = 0;
+	int32_t first_event = 0;
+
+	g_swm.has_sync = XSyncQueryExtension(g_swm.ctx.xconn,
+					     &g_swm.sync_event_base,
+					     &g_swm.sync_error_base) &&
+			 XSyncInitialize(g_swm.ctx.xconn, &major, &minor) &&
+			 XQueryExtension(g_swm.ctx.xconn, SYNC_NAME,
+					 &g_swm.sync_opcode, &first_event,
+					 &error_base);
+}
+
 /// @brief Initializes the cursor states which are:
 ///		- Normal
 ///		- Resize
@@ -307,54 +388,89 @@ static void Swm__init_appearance(void)
 void Swm__startup(void)
 {
 	XSetWindowAttributes wa;
+	pthread_t fontconfig;
+	uint64_t start_us = Timing__now_us();
+	uint64_t phase_us = start_us;
+
 	if (!g_swm.is_running) {
+		// Fontconfig loads on its own while the X setup goes on
+		if (pthread_create(&fontconfig, NULL, Swm__init_fontconfig,
+				   NULL)) {
+			die("pthread_create:");
+		}
+
 		// Initialize the main fields of slacker with sane defaults.
 		Swm__init();
+		Swm__startup_phase("connect", &phase_us);
 
 		// Check to see if a different window manager is running.
 		Swm__checkotherwm();
+		Swm__startup_phase("checkotherwm", &phase_us);
 
 		// If the X context was initialized, and there are no other window managers running,
 		// we can assume we are good to run the window manager.
 		g_swm.is_running = true;
 
-		// Create Draw object, and fonts
-		Swm__init_fonts();
-
-		// Creates monitors and sets the current monitor to the first one
-		Swm__updategeom();
-
 		// Init Atoms
 		Atom utf8string = Swm__init_atoms();
 
 		// Add support for EWMH and NetWM
 		Swm__init_ewmh_support(utf8string);
+		Swm__startup_phase("atoms", &phase_us);
 
-		// Init cursors
-		Swm__init_cursor_states(&wa);
+		// Query the SYNC and RandR extensions
+		Swm__init_sync();
+		Randr__init();
+		Swm__startup_phase("extensions", &phase_us);
 
-		// Init appearance
+		// Create Draw object, cursors and colors, these are requests
+		// without replies
+		Swm__init_draw();
+		Swm__init_cursor_states(&wa);
 		Swm__init_appearance();
+		Swm__startup_phase("appearance", &phase_us);
+
+		// Fonts decide the bar height, which the monitors need
+		Swm__init_fonts(fontconfig);
+		Swm__startup_phase("fonts", &phase_us);
+
+		// Creates monitors and sets the current monitor to the first one
+		Swm__updategeom();
+		Swm__startup_phase("monitors", &phase_us);
 
 		// Register the events we plan to support with X
 		wa.event_mask = SubstructureRedirectMask |
 				SubstructureNotifyMask | ButtonPressMask |
-				PointerMotionMask | EnterWindowMask |
-				LeaveWindowMask | StructureNotifyMask |
-				PropertyChangeMask;
+				EnterWindowMask | LeaveWindowMask |
+				StructureNotifyMask | PropertyChangeMask;
 
 		XChangeWindowAttributes(g_swm.ctx.xconn, g_swm.ctx.xroot_id,
 					CWEventMask | CWCursor, &wa);
 		XSelectInput(g_swm.ctx.xconn, g_swm.ctx.xroot_id,
 			     wa.event_mask);
 
-		// Init bars
+		// Init bars and monitor backdrops
 		Swm__updatebars();
+		Swm__update_backdrops();
 		Swm__update_status();
+		Swm__startup_phase("bars", &phase_us);
 
+		Swm__update_numlock_mask();
 		Swm__grab_keys();
+		Swm__startup_phase("keys", &phase_us);
+
 		Swm__focus(NULL);
 		Swm__scan();
+		Swm__startup_phase("scan", &phase_us);
+
+#if (DEBUG == true)
+		// Until the server has processed everything, release builds
+		// leave that to the XSync at the start of `Swm__run`
+		XSync(g_swm.ctx.xconn, False);
+		Swm__startup_phase("sync", &phase_us);
+		fprintf(stdout, "startup: %-12s %7.2f ms\n", "total",
+			(phase_us - start_us) / 1000.0);
+#endif
 	}
 }
 
@@ -384,6 +500,12 @@ void Swm__delete(void)
 		Monitor__delete(g_swm.monitor_list);
 	}
 
+	// Every client and monitor is back in its pool now
+	Pool__log(&g_swm.client_pool);
+	Pool__log(&g_swm.monitor_pool);
+	Pool__delete(&g_swm.client_pool);
+	Pool__delete(&g_swm.monitor_pool);
+
 	// free all cursors
 	for (size_t i = 0; i < SlackerCursorState_Last; ++i) {
 		drw_cur_free(g_swm.draw, g_swm.cursor[i]);
@@ -399,8 +521,10 @@ void Swm__delete(void)
 		free(g_swm.scheme);
 	}
 
-	// Free the drawable abstraction
+	// Free the drawable abstraction, the fonts belong to the scales
+	g_swm.draw->fonts = NULL;
 	drw_free(g_swm.draw);
+	BarScale__delete_all();
 
 	XSync(g_swm.ctx.xconn, False);
 	XSetInputFocus(g_swm.ctx.xconn, PointerRoot, RevertToPointerRoot,
@@ -427,7 +551,12 @@ int32_t Swm__xerror_handler(Display *xconn, XErrorEvent *ee)
 	     ee->error_code == BadMatch) ||
 	    (ee->request_code == X_GrabButton && ee->error_code == BadAccess) ||
 	    (ee->request_code == X_GrabKey && ee->error_code == BadAccess) ||
-	    (ee->request_code == X_CopyArea && ee->error_code == BadDrawable)) {
+	    (ee->request_code == X_CopyArea && ee->error_code == BadDrawable) ||
+	    // Sync counters vanish with the client which owns them, and
+	    // our alarms on them with it
+	    (g_swm.has_sync && ee->request_code == g_swm.sync_opcode &&
+	     (ee->error_code == g_swm.sync_error_base + XSyncBadCounter ||
+	      ee->error_code == g_swm.sync_error_base + XSyncBadAlarm))) {
 		return 0;
 	}
 	fprintf(stderr,
@@ -443,9 +572,13 @@ void Swm__applyrules(Client *client)
 	const SlackerWindowRule *window_rule = NULL;
 	Monitor *temp_monitor = NULL;
 	XClassHint ch = { NULL, NULL };
+	// Placement from `Launch__match`, used unless a rule decides
+	Monitor *spawn_monitor = client->mon;
+	uint32_t spawn_tags = client->tags;
 
 	// Rule matching
 	client->isfloating = 0;
+	client->outline_drag = false;
 	client->tags = 0;
 	XGetClassHint(g_swm.ctx.xconn, client->win, &ch);
 	class = ch.res_class ? ch.res_class : CLIENT_WINDOW_BROKEN;
@@ -460,6 +593,7 @@ void Swm__applyrules(Client *client)
 		    (!window_rule->instance ||
 		     strstr(instance, window_rule->instance))) {
 			client->isfloating = window_rule->isfloating;
+			client->outline_drag = window_rule->outline_drag;
 			client->tags |= window_rule->tags;
 			for (temp_monitor = g_swm.monitor_list;
 			     temp_monitor &&
@@ -481,9 +615,18 @@ void Swm__applyrules(Client *client)
 		XFree(ch.res_name);
 	}
 
-	client->tags = client->tags & TAGMASK ?
-			       client->tags & TAGMASK :
-			       client->mon->tag_set[client->mon->selected_tags];
+	if (client->mon != spawn_monitor) {
+		Client__clamp_to_monitor(client);
+		spawn_tags = 0;
+	}
+
+	if (client->tags & TAGMASK) {
+		client->tags &= TAGMASK;
+	} else if (spawn_tags & TAGMASK) {
+		client->tags = spawn_tags & TAGMASK;
+	} else {
+		client->tags = client->mon->tag_set[client->mon->selected_tags];
+	}
 }
 
 int Swm__applysizehints(Client *client, int *x, int *y, int *w, int *h,
@@ -527,11 +670,11 @@ int Swm__applysizehints(Client *client, int *x, int *y, int *w, int *h,
 		}
 	}
 
-	if (*h < g_swm.bar_height) {
-		*h = g_swm.bar_height;
+	if (*h < temp_monitor->bar_scale->bar_height) {
+		*h = temp_monitor->bar_scale->bar_height;
 	}
-	if (*w < g_swm.bar_height) {
-		*w = g_swm.bar_height;
+	if (*w < temp_monitor->bar_scale->bar_height) {
+		*w = temp_monitor->bar_scale->bar_height;
 	}
 
 	if (G_RESIZE_HINTS || client->isfloating ||
@@ -642,55 +785,52 @@ void Swm__drawbar(Monitor *monitor)
 	int32_t x = 0;
 	int32_t w = 0;
 	int32_t text_width = 0;
-	int32_t boxs = g_swm.draw->fonts->h / 9;
-	int32_t boxw = g_swm.draw->fonts->h / 6 + 2;
+	Drw *draw = monitor->draw;
+	BarScale *bar_scale = monitor->bar_scale;
+	int32_t boxs = bar_scale->fonts->h / 9;
+	int32_t boxw = bar_scale->fonts->h / 6 + 2;
 	uint32_t i = 0;
-	uint32_t occ = 0;
-	uint32_t urgent = 0;
-	Client *temp_client;
+	// Kept up to date by `Monitor__count_client`
+	const uint32_t occ = monitor->occupied_tags;
+	const uint32_t urgent = monitor->urgent_tags;
 
-	if (!monitor->show_bar) {
+	// Whatever was deferred gets drawn now
+	monitor->bar_redraw_us = 0;
+	if (!monitor->show_bar || !draw) {
 		return;
 	}
+	monitor->bar_drawn_us = Timing__now_us();
 
 	// Draw status first so it can be overdrawn by tags later.
 	// Status is only drawn on the selected monitor
 	if (monitor == g_swm.selected_monitor) {
 		// Calculate the width of the status text and add 2x padding
-		text_width = TEXTW(g_swm.status_text) -
-			     (g_swm.left_right_padding_sum);
+		text_width = TEXTW(monitor, g_swm.status_text) -
+			     (bar_scale->left_right_padding_sum);
 
-		drw_setscheme(g_swm.draw,
+		drw_setscheme(draw,
 			      g_swm.scheme[SlackerColorscheme_Norm]);
 
-		drw_text(g_swm.draw, (monitor->ww - text_width), 0, text_width,
-			 g_swm.bar_height, 0, g_swm.status_text, 0);
-	}
-
-	for (temp_client = monitor->client_list; temp_client;
-	     temp_client = temp_client->next) {
-		occ |= temp_client->tags;
-		if (temp_client->isurgent) {
-			urgent |= temp_client->tags;
-		}
+		drw_text(draw, (monitor->ww - text_width), 0, text_width,
+			 bar_scale->bar_height, 0, g_swm.status_text, 0);
 	}
 
 	// Draw the tags
 	for (i = 0; i < LENGTH(G_TAGS); ++i) {
-		w = TEXTW(G_TAGS[i]);
+		w = TEXTW(monitor, G_TAGS[i]);
 		drw_setscheme(
-			g_swm.draw,
+			draw,
 			g_swm.scheme[monitor->tag_set[monitor->selected_tags] &
 						     1 << i ?
 					     SlackerColorscheme_Sel :
 					     SlackerColorscheme_Norm]);
 
-		drw_text(g_swm.draw, x, 0, w, g_swm.bar_height,
-			 (g_swm.left_right_padding_sum / 2), G_TAGS[i],
+		drw_text(draw, x, 0, w, bar_scale->bar_height,
+			 (bar_scale->left_right_padding_sum / 2), G_TAGS[i],
 			 urgent & 1 << i);
 
 		if (occ & 1 << i) {
-			drw_rect(g_swm.draw, (x + boxs), boxs, boxw, boxw,
+			drw_rect(draw, (x + boxs), boxs, boxw, boxw,
 				 monitor == g_swm.selected_monitor &&
 					 g_swm.selected_monitor
 						 ->selected_client &&
@@ -704,40 +844,59 @@ void Swm__drawbar(Monitor *monitor)
 	}
 
 	// Draw the layout symbol
-	w = TEXTW(monitor->layout_symbol);
-	drw_setscheme(g_swm.draw, g_swm.scheme[SlackerColorscheme_Norm]);
-	x = drw_text(g_swm.draw, x, 0, w, g_swm.bar_height,
-		     (g_swm.left_right_padding_sum / 2), monitor->layout_symbol,
+	w = TEXTW(monitor, monitor->layout_symbol);
+	drw_setscheme(draw, g_swm.scheme[SlackerColorscheme_Norm]);
+	x = drw_text(draw, x, 0, w, bar_scale->bar_height,
+		     (bar_scale->left_right_padding_sum / 2), monitor->layout_symbol,
 		     0);
 
-	if ((w = monitor->ww - text_width - x) > g_swm.bar_height) {
+	if ((w = monitor->ww - text_width - x) > bar_scale->bar_height) {
 		if (monitor->selected_client) {
 			enum SlackerColorscheme colorscheme =
 				(monitor == g_swm.selected_monitor ?
 					 SlackerColorscheme_Sel :
 					 SlackerColorscheme_Norm);
 
-			drw_setscheme(g_swm.draw, g_swm.scheme[colorscheme]);
+			drw_setscheme(draw, g_swm.scheme[colorscheme]);
 
-			drw_text(g_swm.draw, x, 0, w, g_swm.bar_height,
-				 (g_swm.left_right_padding_sum / 2),
+			drw_text(draw, x, 0, w, bar_scale->bar_height,
+				 (bar_scale->left_right_padding_sum / 2),
 				 monitor->selected_client->name, 0);
 
 			if (monitor->selected_client->isfloating) {
-				drw_rect(g_swm.draw, x + boxs, boxs, boxw, boxw,
+				drw_rect(draw, x + boxs, boxs, boxw, boxw,
 					 monitor->selected_client->isfixed, 0);
 			}
 
 		} else {
-			drw_setscheme(g_swm.draw,
+			drw_setscheme(draw,
 				      g_swm.scheme[SlackerColorscheme_Norm]);
 
-			drw_rect(g_swm.draw, x, 0, w, g_swm.bar_height, 1, 1);
+			drw_rect(draw, x, 0, w, bar_scale->bar_height, 1, 1);
 		}
 	}
 
-	drw_map(g_swm.draw, monitor->bar_win_id, 0, 0, monitor->ww,
-		g_swm.bar_height);
+	drw_map(draw, monitor->bar_win_id, 0, 0, monitor->ww,
+		bar_scale->bar_height);
+}
+
+void Swm__schedule_drawbar(Monitor *monitor)
+{
+	uint64_t now_us = Timing__now_us();
+
+	if (!monitor->frame_us) {
+		monitor->frame_us =
+			1000000 / Randr__refresh_rate_at(
+					  monitor->mx + monitor->mw / 2,
+					  monitor->my + monitor->mh / 2);
+	}
+
+	if (now_us >= monitor->bar_drawn_us + monitor->frame_us) {
+		Swm__drawbar(monitor);
+	} else if (!monitor->bar_redraw_us) {
+		monitor->bar_redraw_us =
+			monitor->bar_drawn_us + monitor->frame_us;
+	}
 }
 
 void Swm__drawbars(void)
@@ -757,9 +916,11 @@ void Swm__focus(Client *client)
 		return;
 	}
 
+	// Nothing in view, don't walk the clients on other tags
 	if (!client || !ISVISIBLE(client))
-		for (client = sm->client_stack; client && !ISVISIBLE(client);
-		     client = client->stack_next) {
+		for (client = Monitor__get_num_clients(sm) ? sm->client_stack :
+							     NULL;
+		     client && !ISVISIBLE(client); client = client->stack_next) {
 			;
 		}
 
@@ -879,81 +1040,257 @@ bool Swm__get_text_prop(Window w_id, Atom atom, char *text, uint32_t size)
 	return true;
 }
 
+/// @brief Reads a UTF8_STRING property straight into `text`.
+///
+/// @details One request and no locale conversion, the bar draws UTF-8.
+/// A title longer than `text` is cut at a character boundary.
+///
+/// @returns The type of the property, None if the window doesn't have it.
+/// `text` is only filled in when the type is UTF8_STRING.
+static Atom Swm__get_utf8_prop(Window w_id, Atom atom, char *text,
+			       uint32_t size)
+{
+	Atom type = None;
+	int32_t format = 0;
+	unsigned long items = 0;
+	unsigned long remaining = 0;
+	unsigned char *data = NULL;
+	size_t len = 0;
+
+	text[0] = '\0';
+	if (XGetWindowProperty(g_swm.ctx.xconn, w_id, atom, 0,
+			       (size + 3) / 4, False,
+			       g_swm.wmatom[SlackerDefaultAtom_Utf8String],
+			       &type, &format, &items, &remaining,
+			       &data) != Success) {
+		return None;
+	}
+
+	if (type == g_swm.wmatom[SlackerDefaultAtom_Utf8String] &&
+	    format == 8 && data) {
+		len = MIN(items, size - 1);
+		memcpy(text, data, len);
+		// Don't leave half of a multibyte character behind
+		if (len < items) {
+			while (len > 0 && (data[len] & 0xc0) == 0x80) {
+				--len;
+			}
+		}
+		text[len] = '\0';
+	}
+	if (data) {
+		XFree(data);
+	}
+	return type;
+}
+
 void Swm__grab_buttons(Client *client, bool focused)
 {
-	Swm__update_numlock_mask();
-	{
-		// Clear all buttons
-		XUngrabButton(g_swm.ctx.xconn, AnyButton, AnyModifier,
-			      client->win);
+	uint32_t button_grab = focused ? SlackerButtonGrab_Focused :
+					 SlackerButtonGrab_Unfocused;
+	uint32_t modifiers[] = { 0, LockMask, g_swm.numlockmask,
+				 (g_swm.numlockmask | LockMask) };
+
+	// Nothing to send when the window already has these grabs
+	if (client->button_grab == button_grab) {
+		return;
+	}
+	client->button_grab = button_grab;
+
+	// Clear all buttons
+	XUngrabButton(g_swm.ctx.xconn, AnyButton, AnyModifier, client->win);
 
-		if (!focused) {
-			XGrabButton(g_swm.ctx.xconn, AnyButton, AnyModifier,
-				    client->win, False, BUTTONMASK,
-				    GrabModeSync, GrabModeSync, None, None);
-		}
-
-		uint32_t modifiers[] = { 0, LockMask, g_swm.numlockmask,
-					 (g_swm.numlockmask | LockMask) };
-
-		for (uint32_t i = 0; i < LENGTH(G_CLICKABLE_BUTTONS); ++i) {
-			// if the button is a client window button, grab it
-			if (G_CLICKABLE_BUTTONS[i].click ==
-			    SlackerClick_ClientWin) {
-				for (uint32_t j = 0; j < LENGTH(modifiers); ++j)
-					XGrabButton(
-						g_swm.ctx.xconn,
-						G_CLICKABLE_BUTTONS[i].id,
-						G_CLICKABLE_BUTTONS[i]
-								.event_mask |
-							modifiers[j],
-						client->win, False, BUTTONMASK,
-						GrabModeAsync, GrabModeSync,
-						None, None);
+	if (!focused) {
+		XGrabButton(g_swm.ctx.xconn, AnyButton, AnyModifier,
+			    client->win, False, BUTTONMASK, GrabModeSync,
+			    GrabModeSync, None, None);
+	}
+
+	for (uint32_t i = 0; i < LENGTH(G_CLICKABLE_BUTTONS); ++i) {
+		// if the button is a client window button, grab it
+		if (G_CLICKABLE_BUTTONS[i].click == SlackerClick_ClientWin) {
+			for (uint32_t j = 0; j < LENGTH(modifiers); ++j)
+				XGrabButton(g_swm.ctx.xconn,
+					    G_CLICKABLE_BUTTONS[i].id,
+					    G_CLICKABLE_BUTTONS[i].event_mask |
+						    modifiers[j],
+					    client->win, False, BUTTONMASK,
+					    GrabModeAsync, GrabModeSync, None,
+					    None);
+		}
+	}
+}
+
+void Swm__add_key_dispatch(KeyCode keycode, uint32_t binding)
+{
+	uint8_t *slot = &g_swm.key_dispatch[keycode]
+					   [CLEANMASK(G_KEYBINDINGS[binding].mod)];
+
+	// Keep the order of G_KEYBINDINGS when several bindings share a key
+	while (*slot) {
+		slot = &g_swm.key_dispatch_next[*slot - 1];
+	}
+	*slot = binding + 1;
+	g_swm.key_dispatch_next[binding] = 0;
+}
+
+/// @brief Indices into G_KEYBINDINGS of the bindings with a handler, sorted
+/// by keysym. The bindings never change, the index is built once.
+static uint8_t s_bindings_by_keysym[MAX_KEY_BINDINGS];
+static uint32_t s_num_bindings_by_keysym = 0;
+
+/// @brief One XGrabKey request in flight, see `Swm__grab_keys_error_handler`
+typedef struct KeyGrab KeyGrab;
+struct KeyGrab {
+	/// Serial of the request
+	unsigned long serial;
+	/// Index into G_KEYBINDINGS of the binding being grabbed
+	uint32_t binding;
+};
+
+static KeyGrab *s_key_grabs = NULL;
+static uint32_t s_num_key_grabs = 0;
+static uint32_t s_key_grabs_capacity = 0;
+
+/// @brief qsort comparator ordering binding indices by keysym.
+///
+/// @details qsort isn't stable, ties go by index so bindings sharing a
+/// key are dispatched in the order of G_KEYBINDINGS.
+static int Swm__compare_binding_keysyms(const void *a, const void *b)
+{
+	uint8_t lhs_index = *(const uint8_t *)a;
+	uint8_t rhs_index = *(const uint8_t *)b;
+	KeySym lhs = G_KEYBINDINGS[lhs_index].keysym;
+	KeySym rhs = G_KEYBINDINGS[rhs_index].keysym;
+
+	if (lhs != rhs) {
+		return (lhs > rhs) - (lhs < rhs);
+	}
+	return (lhs_index > rhs_index) - (lhs_index < rhs_index);
+}
+
+/// @brief Sorts the bindings with a handler by keysym, once.
+static void Swm__index_key_bindings(void)
+{
+	if (s_num_bindings_by_keysym) {
+		return;
+	}
+
+	for (uint32_t i = 0; i < LENGTH(G_KEYBINDINGS); ++i) {
+		if (G_KEYBINDINGS[i].handler) {
+			s_bindings_by_keysym[s_num_bindings_by_keysym++] = i;
+		}
+	}
+	qsort(s_bindings_by_keysym, s_num_bindings_by_keysym,
+	      sizeof(s_bindings_by_keysym[0]), Swm__compare_binding_keysyms);
+}
+
+/// @brief Finds the first binding of a keysym in the sorted index.
+///
+/// @returns The position in `s_bindings_by_keysym`, past the end if the
+/// keysym is not bound
+static uint32_t Swm__find_keysym_binding(KeySym keysym)
+{
+	uint32_t low = 0;
+	uint32_t high = s_num_bindings_by_keysym;
+	uint32_t mid = 0;
+
+	while (low < high) {
+		mid = low + (high - low) / 2;
+		if (G_KEYBINDINGS[s_bindings_by_keysym[mid]].keysym < keysym) {
+			low = mid + 1;
+		} else {
+			high = mid;
+		}
+	}
+	return low;
+}
+
+/// @brief Reports grabs another client already holds, by the serial of the
+/// failed request. Every other error goes to `Swm__xerror_handler`.
+static int32_t Swm__grab_keys_error_handler(Display *xconn, XErrorEvent *ee)
+{
+	if (ee->request_code == X_GrabKey) {
+		for (uint32_t i = 0; i < s_num_key_grabs; ++i) {
+			if (s_key_grabs[i].serial == ee->serial) {
+				fprintf(stderr,
+					"slacker: key binding %u (keysym 0x%lx) "
+					"is grabbed by another client\n",
+					s_key_grabs[i].binding,
+					G_KEYBINDINGS[s_key_grabs[i].binding]
+						.keysym);
+				return 0;
 			}
 		}
 	}
+	return Swm__xerror_handler(xconn, ee);
+}
+
+/// @brief Queues one XGrabKey and remembers its serial.
+static void Swm__grab_key(KeyCode keycode, uint32_t modifiers,
+			  uint32_t binding)
+{
+	if (s_num_key_grabs == s_key_grabs_capacity) {
+		s_key_grabs_capacity = MAX(s_key_grabs_capacity * 2, 64);
+		s_key_grabs = realloc(s_key_grabs,
+				      s_key_grabs_capacity * sizeof(KeyGrab));
+		if (!s_key_grabs) {
+			die("realloc:");
+		}
+	}
+
+	s_key_grabs[s_num_key_grabs++] = (KeyGrab){
+		.serial = NextRequest(g_swm.ctx.xconn),
+		.binding = binding,
+	};
+	XGrabKey(g_swm.ctx.xconn, keycode, modifiers, g_swm.ctx.xroot_id, True,
+		 GrabModeAsync, GrabModeAsync);
 }
 
 void Swm__grab_keys(void)
 {
-	Swm__update_numlock_mask();
-	{
-		uint32_t modifiers[] = { 0, LockMask, g_swm.numlockmask,
-					 g_swm.numlockmask | LockMask };
-
-		int32_t start = 0;
-		int32_t end = 0;
-		int32_t skip = 0;
-
-		XUngrabKey(g_swm.ctx.xconn, AnyKey, AnyModifier,
-			   g_swm.ctx.xroot_id);
-		XDisplayKeycodes(g_swm.ctx.xconn, &start, &end);
-		KeySym *syms = XGetKeyboardMapping(g_swm.ctx.xconn, start,
-						   (end - (start + 1)), &skip);
-		if (!syms) {
-			return;
-		}
-
-		for (uint32_t k = start; k <= end; ++k) {
-			for (uint32_t i = 0; i < LENGTH(G_KEYBINDINGS); ++i) {
-				// Skip modifier codes, we do that ourselves
-				if (G_KEYBINDINGS[i].keysym ==
-				    syms[(k - start) * skip]) {
-					for (uint32_t j = 0;
-					     j < LENGTH(modifiers); ++j) {
-						XGrabKey(g_swm.ctx.xconn, k,
-							 G_KEYBINDINGS[i].mod |
-								 modifiers[j],
-							 g_swm.ctx.xroot_id,
-							 True, GrabModeAsync,
-							 GrabModeAsync);
-					}
-				}
+	uint32_t modifiers[] = { 0, LockMask, 0, LockMask };
+	uint32_t binding = 0;
+	int32_t start = 0;
+	int32_t end = 0;
+	int32_t skip = 0;
+	KeySym *syms = NULL;
+
+	modifiers[2] = g_swm.numlockmask;
+	modifiers[3] = g_swm.numlockmask | LockMask;
+	Swm__index_key_bindings();
+
+	XUngrabKey(g_swm.ctx.xconn, AnyKey, AnyModifier, g_swm.ctx.xroot_id);
+	memset(g_swm.key_dispatch, 0, sizeof(g_swm.key_dispatch));
+	XDisplayKeycodes(g_swm.ctx.xconn, &start, &end);
+	if (!(syms = XGetKeyboardMapping(g_swm.ctx.xconn, start,
+					 (end - start + 1), &skip))) {
+		return;
+	}
+
+	// Every keycode looks up its keysym among the bound ones, the grabs
+	// are sent as one batch and checked with a single round trip.
+	s_num_key_grabs = 0;
+	XSetErrorHandler(Swm__grab_keys_error_handler);
+	for (int32_t k = start; k <= end; ++k) {
+		for (uint32_t i = Swm__find_keysym_binding(
+			     syms[(k - start) * skip]);
+		     i < s_num_bindings_by_keysym &&
+		     G_KEYBINDINGS[binding = s_bindings_by_keysym[i]].keysym ==
+			     syms[(k - start) * skip];
+		     ++i) {
+			Swm__add_key_dispatch(k, binding);
+			for (uint32_t j = 0; j < LENGTH(modifiers); ++j) {
+				Swm__grab_key(k,
+					      G_KEYBINDINGS[binding].mod |
+						      modifiers[j],
+					      binding);
 			}
 		}
-		XFree(syms);
 	}
+	XFree(syms);
+	XSync(g_swm.ctx.xconn, False);
+	XSetErrorHandler(Swm__xerror_handler);
 }
 
 void Swm__manage_client(Window w_id, XWindowAttributes *wa)
@@ -970,32 +1307,32 @@ void Swm__manage_client(Window w_id, XWindowAttributes *wa)
 		new_client->tags = temp_client->tags;
 	} else {
 		new_client = Client__new(w_id, wa, g_swm.selected_monitor);
+		// Opens where it was spawned from, rules may still move it.
+		// Also decides whether the first expose gets measured.
+		Launch__match(new_client);
 		Swm__applyrules(new_client);
 	}
 	Swm__update_client_title(new_client);
 
-	wc.border_width = new_client->bw;
-	XConfigureWindow(g_swm.ctx.xconn, w_id, CWBorderWidth, &wc);
 	XSetWindowBorder(
 		g_swm.ctx.xconn, w_id,
 		g_swm.scheme[SlackerColorscheme_Norm][ColBorder].pixel);
 
-	// Propagates border_width, if size doesn't change
-	Client__configure(g_swm.ctx.xconn, new_client);
-
 	Swm__update_window_type(new_client);
 	Client__update_size_hints(g_swm.ctx.xconn, new_client);
 
 	Swm__update_wmhints(new_client);
+	Swm__update_sync_counter(new_client);
+	// A window of a spawned program also reports its first expose
 	XSelectInput(g_swm.ctx.xconn, w_id,
-		     EnterWindowMask | FocusChangeMask | PropertyChangeMask |
-			     StructureNotifyMask);
+		     CLIENTMASK |
+			     (new_client->launch_stats ? ExposureMask : 0));
 
 	Swm__grab_buttons(new_client, false);
 
 	if (!new_client->isfloating) {
-		new_client->isfloating = new_client->oldstate =
-			trans != None || new_client->isfixed;
+		new_client->oldstate = trans != None || new_client->isfixed;
+		new_client->isfloating = new_client->oldstate;
 	}
 
 	if (new_client->isfloating) {
@@ -1009,10 +1346,10 @@ void Swm__manage_client(Window w_id, XWindowAttributes *wa)
 			32, PropModeAppend, (unsigned char *)&(new_client->win),
 			1);
 
-	XMoveResizeWindow(g_swm.ctx.xconn, new_client->win,
-			  new_client->x + 2 * g_swm.ctx.xscreen_width,
-			  new_client->y, new_client->w,
-			  new_client->h); /* some windows require this */
+	// Still unmapped, so nothing has to be moved off screen. A window
+	// for a tag that isn't shown counts as parked and is configured
+	// there below, a shown one gets its final geometry from the arrange.
+	new_client->hidden = !ISVISIBLE(new_client);
 
 	Swm__set_client_state(new_client, NormalState);
 	if (new_client->mon == g_swm.selected_monitor) {
@@ -1021,7 +1358,25 @@ void Swm__manage_client(Window w_id, XWindowAttributes *wa)
 
 	new_client->mon->selected_client = new_client;
 	Swm__arrange_monitors(new_client->mon);
+
+	// The arrange didn't touch it, e.g a floating window keeping the
+	// geometry it asked for. It still needs its border width.
+	if (new_client->needs_configure) {
+		wc.x = new_client->hidden ? WIDTH(new_client) * -2 :
+					    new_client->x;
+		wc.y = new_client->y;
+		wc.width = new_client->w;
+		wc.height = new_client->h;
+		wc.border_width = new_client->bw;
+		XConfigureWindow(g_swm.ctx.xconn, new_client->win,
+				 CWX | CWY | CWWidth | CWHeight |
+					 CWBorderWidth,
+				 &wc);
+		Client__configure(g_swm.ctx.xconn, new_client);
+		new_client->needs_configure = false;
+	}
 	XMapWindow(g_swm.ctx.xconn, new_client->win);
+	Launch__mapped(new_client);
 	Swm__focus(NULL);
 }
 
@@ -1047,18 +1402,26 @@ void Swm__resize_client(Client *client, int x, int y, int w, int h)
 {
 	XWindowChanges wc = Client__update_dimensions(client, x, y, w, h);
 
+	// Parked windows are resized in place, they are moved in when shown
+	if (client->hidden) {
+		wc.x = WIDTH(client) * -2;
+	}
 	XConfigureWindow(g_swm.ctx.xconn, client->win,
 			 CWX | CWY | CWWidth | CWHeight | CWBorderWidth, &wc);
+	client->needs_configure = false;
 
 	Client__configure(g_swm.ctx.xconn, client);
 
-	XSync(g_swm.ctx.xconn, False);
+	// Nothing waits on a parked window, e.g while hidden tags are
+	// prepared, the requests go out with the next flush
+	if (!client->hidden) {
+		XSync(g_swm.ctx.xconn, False);
+	}
 }
 
 void Swm__restack(Monitor *monitor)
 {
 	Client *temp_client = NULL;
-	XEvent ev;
 	XWindowChanges wc;
 
 	Swm__drawbar(monitor);
@@ -1088,18 +1451,141 @@ void Swm__restack(Monitor *monitor)
 		}
 	}
 
-	XSync(g_swm.ctx.xconn, false);
-	while (XCheckMaskEvent(g_swm.ctx.xconn, EnterWindowMask, &ev)) {
-		;
+	Swm__ignore_enter_events();
+}
+
+void Swm__grab_server(void)
+{
+	if (g_swm.server_grabs++ == 0) {
+		XGrabServer(g_swm.ctx.xconn);
 	}
 }
 
-void Swm__run(void)
+void Swm__ungrab_server(void)
+{
+	if (g_swm.server_grabs && --g_swm.server_grabs == 0) {
+		XUngrabServer(g_swm.ctx.xconn);
+	}
+}
+
+void Swm__ignore_enter_events(void)
+{
+	g_swm.enter_ignore_serial = NextRequest(g_swm.ctx.xconn);
+	XNoOp(g_swm.ctx.xconn);
+}
+
+/// @brief Waits for the X connection or a second descriptor to become
+/// readable.
+///
+/// @param `deadline_us` Monotonic time in microseconds to give up at, 0 to
+/// wait without a deadline
+/// @param `other_fd` Also wakes up when readable, ignored if negative
+///
+/// @details Returns at once when Xlib already read events off the socket,
+/// e.g during an XSync of the hidden tag preparation, select() would not
+/// see those.
+///
+/// @returns false if the deadline passed without an event
+static bool Swm__wait_for_event(uint64_t deadline_us, int32_t other_fd)
+{
+	int32_t fd = ConnectionNumber(g_swm.ctx.xconn);
+	uint64_t now_us = Timing__now_us();
+	struct timeval timeout;
+	fd_set fds;
+
+	if (deadline_us && now_us >= deadline_us) {
+		return false;
+	}
+
+	timeout.tv_sec = (deadline_us - now_us) / 1000000;
+	timeout.tv_usec = (deadline_us - now_us) % 1000000;
+	FD_ZERO(&fds);
+	FD_SET(fd, &fds);
+	if (other_fd >= 0) {
+		FD_SET(other_fd, &fds);
+	}
+
+	// Nothing may sit in the output buffer while we block
+	XFlush(g_swm.ctx.xconn);
+	if (QLength(g_swm.ctx.xconn) > 0) {
+		return true;
+	}
+
+	// Interrupted waits count as woken up, the caller checks again
+	return select(MAX(fd, other_fd) + 1, &fds, NULL, NULL,
+		      deadline_us ? &timeout : NULL) != 0;
+}
+
+/// @brief The earlier of two deadlines, where 0 means none.
+static uint64_t Swm__earliest_us(uint64_t a_us, uint64_t b_us)
+{
+	if (!a_us || !b_us) {
+		return a_us ? a_us : b_us;
+	}
+	return MIN(a_us, b_us);
+}
+
+/// @brief The earliest of the pending monitor update, autostart restart
+/// and deferred bar redraws.
+static uint64_t Swm__next_deadline_us(Autostart *as)
+{
+	uint64_t deadline_us = Swm__earliest_us(g_swm.monitor_update_us,
+						Autostart__deadline_us(as));
+
+	for (Monitor *m = g_swm.monitor_list; m; m = m->next) {
+		deadline_us = Swm__earliest_us(deadline_us, m->bar_redraw_us);
+	}
+	return deadline_us;
+}
+
+/// @brief Draws the bars whose deferred title change is due.
+static void Swm__drawbars_due(uint64_t now_us)
+{
+	for (Monitor *m = g_swm.monitor_list; m; m = m->next) {
+		if (m->bar_redraw_us && now_us >= m->bar_redraw_us) {
+			Swm__drawbar(m);
+		}
+	}
+}
+
+void Swm__run(Autostart *as)
 {
 	XEvent ev;
+	Monitor *monitor = NULL;
+	// An outline drag is taken off the screen while other events paint
+	bool outline = false;
+
 	XSync(g_swm.ctx.xconn, False);
-	while (g_swm.is_running && !XNextEvent(g_swm.ctx.xconn, &ev)) {
+	while (g_swm.is_running) {
+		if (!XPending(g_swm.ctx.xconn)) {
+			// Use the idle time before blocking to prepare hidden
+			// tags, unless a drag wants every cycle
+			if (g_swm.drag.kind == SlackerDragKind_None) {
+				for (monitor = g_swm.monitor_list; monitor;
+				     monitor = monitor->next) {
+					Monitor__prepare_hidden_tags(monitor);
+				}
+			}
+
+			// Block until an event, a child exit or the next
+			// deadline
+			Swm__wait_for_event(Swm__next_deadline_us(as),
+					    Autostart__fd(as));
+			Autostart__supervise(as);
+			if (g_swm.monitor_update_us &&
+			    Timing__now_us() >= g_swm.monitor_update_us) {
+				Swm__update_monitors();
+			}
+			Swm__drawbars_due(Timing__now_us());
+			continue;
+		}
+
+		XNextEvent(g_swm.ctx.xconn, &ev);
+		outline = Drag__suspend_outline(&ev);
 		Swm__event_loop(&ev);
+		if (outline) {
+			Drag__resume_outline();
+		}
 	}
 }
 
@@ -1151,6 +1637,120 @@ bool Swm__send_event(Client *client, Atom proto)
 	return exists;
 }
 
+void Swm__update_sync_counter(Client *client)
+{
+	int32_t format = 0;
+	int32_t number_of_protocols = 0;
+	uint64_t n = 0;
+	uint64_t extra = 0;
+	unsigned char *p = NULL;
+	Atom *protocols = NULL;
+	Atom real;
+	bool supported = false;
+
+	client->sync_counter = None;
+	if (!g_swm.has_sync) {
+		return;
+	}
+
+	if (XGetWMProtocols(g_swm.ctx.xconn, client->win, &protocols,
+			    &number_of_protocols)) {
+		while (!supported && number_of_protocols--) {
+			supported =
+				protocols[number_of_protocols] ==
+				g_swm.netatom[SlackerEWMHAtom_NetWMSyncRequest];
+		}
+		XFree(protocols);
+	}
+
+	if (supported &&
+	    XGetWindowProperty(
+		    g_swm.ctx.xconn, client->win,
+		    g_swm.netatom[SlackerEWMHAtom_NetWMSyncRequestCounter], 0L,
+		    1L, False, XA_CARDINAL, &real, &format, &n, &extra,
+		    &p) == Success &&
+	    p) {
+		if (n == 1 && format == 32) {
+			client->sync_counter = *(XSyncCounter *)p;
+		}
+		XFree(p);
+	}
+
+	// A new counter starts over, a stale request can never be acknowledged
+	client->sync_pending = false;
+}
+
+bool Swm__sync_request(Client *client)
+{
+	XEvent ev;
+	XSyncValue one;
+	XSyncAlarmAttributes attrs;
+	int32_t overflow = 0;
+
+	if (!client->sync_counter) {
+		return false;
+	}
+
+	XSyncIntToValue(&one, 1);
+	XSyncValueAdd(&client->sync_value, client->sync_value, one, &overflow);
+
+	ev.type = ClientMessage;
+	ev.xclient.window = client->win;
+	ev.xclient.message_type = g_swm.wmatom[SlackerDefaultAtom_WMProtocols];
+	ev.xclient.format = 32;
+	ev.xclient.data.l[0] = g_swm.netatom[SlackerEWMHAtom_NetWMSyncRequest];
+	ev.xclient.data.l[1] = CurrentTime;
+	ev.xclient.data.l[2] = XSyncValueLow32(client->sync_value);
+	ev.xclient.data.l[3] = XSyncValueHigh32(client->sync_value);
+	ev.xclient.data.l[4] = 0;
+	XSendEvent(g_swm.ctx.xconn, client->win, False, NoEventMask, &ev);
+
+	// Fire once the counter of the client reaches the value we just sent
+	attrs.trigger.counter = client->sync_counter;
+	attrs.trigger.value_type = XSyncAbsolute;
+	attrs.trigger.wait_value = client->sync_value;
+	attrs.trigger.test_type = XSyncPositiveComparison;
+	attrs.events = True;
+	if (client->sync_alarm) {
+		XSyncChangeAlarm(g_swm.ctx.xconn, client->sync_alarm,
+				 XSyncCACounter | XSyncCAValue, &attrs);
+	} else {
+		client->sync_alarm = XSyncCreateAlarm(
+			g_swm.ctx.xconn,
+			XSyncCACounter | XSyncCAValueType | XSyncCAValue |
+				XSyncCATestType | XSyncCAEvents,
+			&attrs);
+	}
+
+	client->sync_pending = true;
+	client->sync_sent_us = Timing__now_us();
+	return true;
+}
+
+bool Swm__sync_acknowledged(Client *client, XEvent *event)
+{
+	XSyncAlarmNotifyEvent *ev = (XSyncAlarmNotifyEvent *)event;
+
+	if (!g_swm.has_sync || !client->sync_pending ||
+	    event->type != g_swm.sync_event_base + XSyncAlarmNotify ||
+	    ev->alarm != client->sync_alarm ||
+	    !XSyncValueGreaterOrEqual(ev->counter_value, client->sync_value)) {
+		return false;
+	}
+
+	client->sync_pending = false;
+	return true;
+}
+
+bool Swm__sync_waiting(Client *client)
+{
+	if (client->sync_pending && Timing__now_us() - client->sync_sent_us >=
+					    SYNC_REQUEST_TIMEOUT_MS * 1000) {
+		client->sync_pending = false;
+	}
+	return client->sync_pending;
+}
+
 void Swm__setfocus(Client *client)
 {
 	if (!client->neverfocus) {
@@ -1179,7 +1779,7 @@ void Swm__setfullscreen(Client *client, int32_t fullscreen)
 		client->oldstate = client->isfloating;
 		client->oldbw = client->bw;
 		client->bw = 0;
-		client->isfloating = 1;
+		Client__set_floating(client, 1);
 		Swm__resize_client(client, client->mon->mx, client->mon->my,
 				   client->mon->mw, client->mon->mh);
 		XRaiseWindow(g_swm.ctx.xconn, client->win);
@@ -1190,7 +1790,7 @@ void Swm__setfullscreen(Client *client, int32_t fullscreen)
 				(unsigned char *)0, 0);
 
 		client->isfullscreen = 0;
-		client->isfloating = client->oldstate;
+		Client__set_floating(client, client->oldstate);
 		client->bw = client->oldbw;
 		client->x = client->oldx;
 		client->y = client->oldy;
@@ -1207,7 +1807,7 @@ void Swm__seturgent(Client *client, int urgent)
 	// TODO: Refactor: Could be a Client__ function by passing Display
 	XWMHints *wmh = NULL;
 
-	client->isurgent = urgent;
+	Client__set_urgent(client, urgent);
 	if (!(wmh = XGetWMHints(g_swm.ctx.xconn, client->win))) {
 		return;
 	}
@@ -1220,25 +1820,47 @@ void Swm__seturgent(Client *client, int urgent)
 void Swm__showhide(Client *client)
 {
 	// TODO: Refactor: Should be a Client__ function
-	if (!client) {
-		return;
+	static Client **s_to_hide = NULL;
+	static uint32_t s_capacity = 0;
+	uint32_t num_to_hide = 0;
+
+	// Show clients top down, windows already on screen are left alone
+	for (; client; client = client->stack_next) {
+		if (ISVISIBLE(client)) {
+			if (client->hidden) {
+				XMoveWindow(g_swm.ctx.xconn, client->win,
+					    client->x, client->y);
+				client->hidden = false;
+			}
+			if ((!client->mon->layouts[client->mon->selected_layout]
+				      ->handler ||
+			     client->isfloating) &&
+			    !client->isfullscreen) {
+				Client__resize(client, client->x, client->y,
+					       client->w, client->h, 0);
+			}
+		} else if (!client->hidden) {
+			if (num_to_hide == s_capacity) {
+				s_capacity = s_capacity ? s_capacity * 2 : 64;
+				s_to_hide = realloc(s_to_hide,
+						    s_capacity * sizeof(Client *));
+				if (!s_to_hide) {
+					die("realloc:");
+				}
+			}
+			s_to_hide[num_to_hide++] = client;
+		}
 	}
-	if (ISVISIBLE(client)) {
-		// Show clients top down
-		XMoveWindow(g_swm.ctx.xconn, client->win, client->x, client->y);
-		if ((!client->mon->layouts[client->mon->selected_layout]
-			      ->handler ||
-		     client->isfloating) &&
-		    !client->isfullscreen)
-			Client__resize(client, client->x, client->y, client->w,
-				       client->h, 0);
-		Swm__showhide(client->stack_next);
-	} else {
-		// Hide clients bottom up
-		Swm__showhide(client->stack_next);
+
+	// Hide clients bottom up
+	while (num_to_hide--) {
+		client = s_to_hide[num_to_hide];
 		XMoveWindow(g_swm.ctx.xconn, client->win, WIDTH(client) * -2,
 			    client->y);
+		client->hidden = true;
 	}
+
+	XFlush(g_swm.ctx.xconn);
 }
 
 void Swm__unfocus(Client *client, bool setfocus)
@@ -1265,10 +1887,13 @@ void Swm__unmanage(Client *client, bool destroyed)
 	Monitor *temp_monitor = client->mon;
 	XWindowChanges wc;
 
+	Drag__cancel(client);
+	Launch__forget(client);
+
 	if (!destroyed) {
 		wc.border_width = client->oldbw;
 		// Avoid race conditions
-		XGrabServer(g_swm.ctx.xconn);
+		Swm__grab_server();
 		// Set a dummy error handler function
 		XSetErrorHandler(xerrordummy);
 		// Pass the client window id for input selection
@@ -1282,7 +1907,11 @@ void Swm__unmanage(Client *client, bool destroyed)
 		Swm__set_client_state(client, WithdrawnState);
 		XSync(g_swm.ctx.xconn, False);
 		XSetErrorHandler(Swm__xerror_handler);
-		XUngrabServer(g_swm.ctx.xconn);
+		Swm__ungrab_server();
+	}
+
+	if (client->sync_alarm) {
+		XSyncDestroyAlarm(g_swm.ctx.xconn, client->sync_alarm);
 	}
 
 	Client__delete(client);
@@ -1309,7 +1938,8 @@ void Swm__updatebars(void)
 		// The bar does not exist, create it
 		temp_monitor->bar_win_id = XCreateWindow(
 			g_swm.ctx.xconn, g_swm.ctx.xroot_id, temp_monitor->wx,
-			temp_monitor->bar_y, temp_monitor->ww, g_swm.bar_height,
+			temp_monitor->bar_y, temp_monitor->ww,
+			temp_monitor->bar_scale->bar_height,
 			0, DefaultDepth(g_swm.ctx.xconn, g_swm.ctx.xscreen_id),
 			CopyFromParent,
 			DefaultVisual(g_swm.ctx.xconn, g_swm.ctx.xscreen_id),
@@ -1319,6 +1949,42 @@ void Swm__updatebars(void)
 			      g_swm.cursor[SlackerCursorState_Normal]->cursor);
 		XMapRaised(g_swm.ctx.xconn, temp_monitor->bar_win_id);
 		XSetClassHint(g_swm.ctx.xconn, temp_monitor->bar_win_id, &ch);
+
+		// Back buffer of the bar, drawn with the fonts of its scale
+		temp_monitor->draw = drw_create(
+			g_swm.ctx.xconn, g_swm.ctx.xscreen_id,
+			g_swm.ctx.xroot_id, temp_monitor->mw,
+			temp_monitor->bar_scale->bar_height);
+		drw_setfontset(temp_monitor->draw,
+			       temp_monitor->bar_scale->fonts);
+	}
+}
+
+void Swm__update_backdrops(void)
+{
+	Monitor *temp_monitor = NULL;
+	XSetWindowAttributes wa = { .override_redirect = True,
+				    .event_mask = EnterWindowMask };
+
+	for (temp_monitor = g_swm.monitor_list; temp_monitor;
+	     temp_monitor = temp_monitor->next) {
+		if (temp_monitor->backdrop_win_id) {
+			XMoveResizeWindow(g_swm.ctx.xconn,
+					  temp_monitor->backdrop_win_id,
+					  temp_monitor->mx, temp_monitor->my,
+					  temp_monitor->mw, temp_monitor->mh);
+			continue;
+		}
+
+		// Input only and without ButtonPressMask, clicks still go
+		// through to the root window
+		temp_monitor->backdrop_win_id = XCreateWindow(
+			g_swm.ctx.xconn, g_swm.ctx.xroot_id, temp_monitor->mx,
+			temp_monitor->my, temp_monitor->mw, temp_monitor->mh, 0,
+			0, InputOnly, CopyFromParent,
+			CWOverrideRedirect | CWEventMask, &wa);
+		XMapWindow(g_swm.ctx.xconn, temp_monitor->backdrop_win_id);
+		XLowerWindow(g_swm.ctx.xconn, temp_monitor->backdrop_win_id);
 	}
 }
 
@@ -1345,28 +2011,180 @@ void Swm__update_client_list(void)
 	}
 }
 
+void Swm__schedule_monitor_update(void)
+{
+	g_swm.monitor_update_us =
+		Timing__now_us() + MONITOR_SETTLE_MS * 1000;
+}
+
+void Swm__update_monitors(void)
+{
+	Monitor *temp_monitor = NULL;
+	Client *temp_client = NULL;
+
+	g_swm.monitor_update_us = 0;
+	if (!Swm__updategeom()) {
+		return;
+	}
+
+	Swm__updatebars();
+	Swm__update_backdrops();
+	for (temp_monitor = g_swm.monitor_list; temp_monitor;
+	     temp_monitor = temp_monitor->next) {
+		for (temp_client = temp_monitor->client_list; temp_client;
+		     temp_client = temp_client->next) {
+			if (temp_client->isfullscreen)
+				Swm__resize_client(temp_client,
+						   temp_monitor->mx,
+						   temp_monitor->my,
+						   temp_monitor->mw,
+						   temp_monitor->mh);
+		}
+		XMoveResizeWindow(g_swm.ctx.xconn, temp_monitor->bar_win_id,
+				  temp_monitor->wx, temp_monitor->bar_y,
+				  temp_monitor->ww,
+				  temp_monitor->bar_scale->bar_height);
+	}
+	Swm__focus(NULL);
+	Swm__arrange_monitors(NULL);
+}
+
+/// @brief Gives a monitor a new geometry.
+///
+/// @returns true if the geometry changed
+static bool Swm__set_monitor_geometry(Monitor *monitor,
+				      const MonitorGeometry *geom)
+{
+	if (monitor->mx == geom->x && monitor->my == geom->y &&
+	    monitor->mw == geom->w && monitor->mh == geom->h &&
+	    monitor->scale == geom->scale) {
+		return false;
+	}
+
+	monitor->mx = monitor->wx = geom->x;
+	monitor->my = monitor->wy = geom->y;
+	monitor->mw = monitor->ww = geom->w;
+	monitor->mh = monitor->wh = geom->h;
+	monitor->scale = geom->scale;
+	// May be on another output now
+	monitor->frame_us = 0;
+	monitor->bar_scale = BarScale__get(geom->scale);
+	if (monitor->draw) {
+		drw_resize(monitor->draw, monitor->mw,
+			   monitor->bar_scale->bar_height);
+		drw_setfontset(monitor->draw, monitor->bar_scale->fonts);
+	}
+	Monitor__updatebarpos(monitor);
+	return true;
+}
+
+/// @brief Finds the geometry a monitor is assigned to.
+///
+/// @returns The index into `owners`, -1 if the monitor has none
+static int32_t Swm__monitor_geometry_index(Monitor **owners, int32_t count,
+					   const Monitor *monitor)
+{
+	for (int32_t i = 0; i < count; ++i) {
+		if (owners[i] == monitor) {
+			return i;
+		}
+	}
+	return -1;
+}
+
 bool Swm__updategeom(void)
 {
 	bool dirty = false;
+	int32_t count = 0;
+	int32_t i = 0;
+	MonitorGeometry *geoms = NULL;
+	// Monitor assigned to each geometry
+	Monitor **owners = NULL;
+	Monitor *temp_monitor = NULL;
+	Monitor *next_monitor = NULL;
+	Monitor **tail = NULL;
+	Client *temp_client = NULL;
+
+	count = Randr__monitor_geometries(&geoms);
+	owners = ecalloc(count, sizeof(Monitor *));
 
-	// If it doesn't exist, create it
-	if (!g_swm.monitor_list) {
-		g_swm.monitor_list = Monitor__new();
+	// Monitors whose geometry is still there keep it and are left alone
+	for (temp_monitor = g_swm.monitor_list; temp_monitor;
+	     temp_monitor = temp_monitor->next) {
+		for (i = 0; i < count; ++i) {
+			if (!owners[i] && temp_monitor->mx == geoms[i].x &&
+			    temp_monitor->my == geoms[i].y &&
+			    temp_monitor->mw == geoms[i].w &&
+			    temp_monitor->mh == geoms[i].h &&
+			    temp_monitor->scale == geoms[i].scale) {
+				owners[i] = temp_monitor;
+				break;
+			}
+		}
 	}
 
-	if (g_swm.monitor_list->mw != g_swm.ctx.xscreen_width ||
-	    g_swm.monitor_list->mh != g_swm.ctx.xscreen_height) {
-		dirty = true;
+	// The others take over geometries which changed, in order
+	for (temp_monitor = g_swm.monitor_list; temp_monitor;
+	     temp_monitor = temp_monitor->next) {
+		if (Swm__monitor_geometry_index(owners, count, temp_monitor) >=
+		    0) {
+			continue;
+		}
+		for (i = 0; i < count && owners[i]; ++i) {
+			;
+		}
+		if (i < count) {
+			owners[i] = temp_monitor;
+			dirty |= Swm__set_monitor_geometry(temp_monitor,
+							   &geoms[i]);
+		}
+	}
+
+	// Geometries left over are new monitors
+	for (tail = &g_swm.monitor_list; *tail; tail = &(*tail)->next) {
+		;
+	}
+	for (i = 0; i < count; ++i) {
+		if (!owners[i]) {
+			owners[i] = *tail = Monitor__new();
+			tail = &(*tail)->next;
+			Swm__set_monitor_geometry(owners[i], &geoms[i]);
+			dirty = true;
+		}
+	}
 
-		g_swm.monitor_list->mw = g_swm.monitor_list->ww =
-			g_swm.ctx.xscreen_width;
+	// Monitors without a geometry are gone, only their clients move
+	for (temp_monitor = g_swm.monitor_list; temp_monitor;
+	     temp_monitor = next_monitor) {
+		next_monitor = temp_monitor->next;
+		if (Swm__monitor_geometry_index(owners, count, temp_monitor) >=
+		    0) {
+			continue;
+		}
 
-		g_swm.monitor_list->mh = g_swm.monitor_list->wh =
-			g_swm.ctx.xscreen_height;
+		dirty = true;
+		while ((temp_client = temp_monitor->client_list)) {
+			Client__detach(temp_client);
+			Client__detach_from_stack(temp_client);
+			temp_client->mon = owners[0];
+			Client__attach(temp_client);
+			Client__attach_to_stack(temp_client);
+		}
+		if (temp_monitor == g_swm.selected_monitor) {
+			g_swm.selected_monitor = owners[0];
+		}
+		Monitor__delete(temp_monitor);
+	}
 
-		Monitor__updatebarpos(g_swm.monitor_list);
+	// Numbers follow the order of the list, as used by rules and dmenu
+	for (temp_monitor = g_swm.monitor_list, i = 0; temp_monitor;
+	     temp_monitor = temp_monitor->next, ++i) {
+		temp_monitor->num = i;
 	}
 
+	free(owners);
+	free(geoms);
+
 	if (dirty) {
 		g_swm.selected_monitor = g_swm.monitor_list;
 		g_swm.selected_monitor = Swm__wintomon(g_swm.ctx.xroot_id);
@@ -1376,20 +2194,46 @@ bool Swm__updategeom(void)
 	return dirty;
 }
 
-void Swm__update_numlock_mask(void)
+bool Swm__update_numlock_mask(void)
 {
-	g_swm.numlockmask = 0;
+	uint32_t numlockmask = 0;
+	KeyCode numlock = XKeysymToKeycode(g_swm.ctx.xconn, XK_Num_Lock);
 
 	XModifierKeymap *modmap = XGetModifierMapping(g_swm.ctx.xconn);
 	for (uint32_t i = 0; i < 8; ++i) {
 		for (uint32_t j = 0; j < modmap->max_keypermod; ++j)
-			if (modmap->modifiermap[i * modmap->max_keypermod + j] ==
-			    XKeysymToKeycode(g_swm.ctx.xconn, XK_Num_Lock)) {
-				g_swm.numlockmask = (1 << i);
+			if (numlock &&
+			    modmap->modifiermap[i * modmap->max_keypermod + j] ==
+				    numlock) {
+				numlockmask = (1 << i);
 			}
 	}
 
 	XFreeModifiermap(modmap);
+
+	if (numlockmask == g_swm.numlockmask) {
+		return false;
+	}
+	g_swm.numlockmask = numlockmask;
+	return true;
+}
+
+void Swm__regrab_buttons(void)
+{
+	Monitor *temp_monitor = NULL;
+	Client *temp_client = NULL;
+
+	for (temp_monitor = g_swm.monitor_list; temp_monitor;
+	     temp_monitor = temp_monitor->next) {
+		for (temp_client = temp_monitor->client_list; temp_client;
+		     temp_client = temp_client->next) {
+			temp_client->button_grab = SlackerButtonGrab_None;
+			Swm__grab_buttons(temp_client,
+					  temp_client ==
+						  g_swm.selected_monitor
+							  ->selected_client);
+		}
+	}
 }
 
 void Swm__update_status(void)
@@ -1401,19 +2245,38 @@ void Swm__update_status(void)
 	Swm__drawbar(g_swm.selected_monitor);
 }
 
-void Swm__update_client_title(Client *client)
+bool Swm__update_client_title(Client *client)
 {
-	if (!Swm__get_text_prop(client->win,
-				g_swm.netatom[SlackerEWMHAtom_NetWMName],
-				client->name, sizeof client->name)) {
-		Swm__get_text_prop(client->win, XA_WM_NAME, client->name,
-				   sizeof client->name);
+	char name[MAX_CLIENT_NAME_LEN];
+	Atom net_wm_name = g_swm.netatom[SlackerEWMHAtom_NetWMName];
+	Atom type = Swm__get_utf8_prop(client->win, net_wm_name, name,
+				       sizeof(name));
+	uint64_t hash = 0;
+
+	if (type != g_swm.wmatom[SlackerDefaultAtom_Utf8String] &&
+	    type != None) {
+		Swm__get_text_prop(client->win, net_wm_name, name,
+				   sizeof(name));
+	}
+
+	// A missing or empty _NET_WM_NAME falls back to WM_NAME
+	if (name[0] == '\0') {
+		Swm__get_text_prop(client->win, XA_WM_NAME, name,
+				   sizeof(name));
 	}
 
 	// hack to mark broken clients
-	if (client->name[0] == '\0') {
-		strcpy(client->name, CLIENT_WINDOW_BROKEN);
+	if (name[0] == '\0') {
+		strcpy(name, CLIENT_WINDOW_BROKEN);
 	}
+
+	// Progress output and spinners often write the same title again
+	if ((hash = fnv1a_string(name)) == client->name_hash) {
+		return false;
+	}
+	client->name_hash = hash;
+	strcpy(client->name, name);
+	return true;
 }
 
 void Swm__update_window_type(Client *client)
@@ -1429,7 +2292,7 @@ void Swm__update_window_type(Client *client)
 	}
 
 	if (wtype == g_swm.netatom[SlackerEWMHAtom_NetWMWindowTypeDialog]) {
-		client->isfloating = 1;
+		Client__set_floating(client, 1);
 	}
 }
 
@@ -1443,7 +2306,8 @@ void Swm__update_wmhints(Client *client)
 			wmh->flags &= ~XUrgencyHint;
 			XSetWMHints(g_swm.ctx.xconn, client->win, wmh);
 		} else {
-			client->isurgent = (wmh->flags & XUrgencyHint) ? 1 : 0;
+			Client__set_urgent(client,
+					   (wmh->flags & XUrgencyHint) ? 1 : 0);
 		}
 
 		if (wmh->flags & InputHint) {
@@ -1486,7 +2350,8 @@ Monitor *Swm__wintomon(Window w_id)
 
 	for (temp_monitor = g_swm.monitor_list; temp_monitor;
 	     temp_monitor = temp_monitor->next) {
-		if (w_id == temp_monitor->bar_win_id) {
+		if (w_id == temp_monitor->bar_win_id ||
+		    w_id == temp_monitor->backdrop_win_id) {
 			return temp_monitor;
 		}
 	}
@@ -12,20 +12,23 @@
 
 // Slacker Headers
 
+#include "autostart.h"
+#include "barscale.h"
 #include "client.h"
 #include "common.h"
 #include "constants.h"
 #include "drawable.h"
+#include "drag.h"
+#include "launch.h"
+#include "pool.h"
 
 ///////////////////////////////////////////////////////
 /// 				Helper Macros
 //////////////////////////////////////////////////////
 
-/// @brief Get the text width of a string using the current font.
+/// @brief Get the text width of a string in the bar of a monitor.
 /// Pad it with the left and right padding + 2.
-#define TEXTW(X)                                 \
-	(drw_fontset_getwidth(g_swm.draw, (X)) + \
-	 g_swm.left_right_padding_sum + 2)
+#define TEXTW(M, X) BarScale__text_width((M)->bar_scale, (X))
 
 /// @brief Clean a mask of all the key modifiers
 #define CLEANMASK(mask)                                              \
@@ -39,6 +42,11 @@
 /// @brief Detect mouse movement
 #define MOUSEMASK (BUTTONMASK | PointerMotionMask)
 
+/// @brief Events selected on every managed client window
+#define CLIENTMASK                                                \
+	(EnterWindowMask | FocusChangeMask | PropertyChangeMask | \
+	 StructureNotifyMask)
+
 /// @brief Bit mask to flip between tags
 #define TAGMASK ((1 << LENGTH(G_TAGS)) - 1)
 
@@ -95,14 +103,16 @@ struct Swm {
 	Ctx ctx;
 	/// Status text that is displayed in the top right corner of the bar
 	char status_text[MAX_STATUS_BAR_TEXT_LEN];
-	/// Bar height
-	int32_t bar_height;
-	/// Sum of left and right padding for text
-	int32_t left_right_padding_sum;
 	/// X error callback function
 	SlackerXErrorHandler xerror_callback;
 	/// Num lock mask, defaults to 0
 	uint32_t numlockmask;
+	/// Key bindings by keycode and CLEANMASK of the modifiers, as index + 1
+	/// into G_KEYBINDINGS of the first binding, 0 if nothing is bound.
+	/// Built in `Swm__grab_keys`.
+	uint8_t key_dispatch[MAX_KEYCODES][MAX_CLEAN_MASKS];
+	/// Index + 1 of the next binding for the same key, 0 ends the chain
+	uint8_t key_dispatch_next[MAX_KEY_BINDINGS];
 	/// Window manager Atoms
 	Atom wmatom[SlackerDefaultAtom_WMLast];
 	/// Net Atoms
@@ -113,8 +123,38 @@ struct Swm {
 	SlackerCursor *cursor[SlackerCursorState_Last];
 	/// Slacker color schemes
 	SlackerColor **scheme;
-	/// Drawable abstraction
+	/// Drawable abstraction, creates cursors and colors and measures text
 	Drw *draw;
+	/// Fonts and measurements of every scale in use, see barscale.h
+	BarScale *bar_scales;
+	/// The X server supports the SYNC extension
+	bool has_sync;
+	/// First event code, first error code and major opcode of the SYNC
+	/// extension
+	int32_t sync_event_base;
+	int32_t sync_error_base;
+	int32_t sync_opcode;
+	/// The X server supports the RandR extension, see randr.h
+	bool has_randr;
+	/// First event code of the RandR extension
+	int32_t randr_event_base;
+	/// The RandR extension is 1.5 or newer and lists physical monitors
+	bool has_randr_monitors;
+	/// Monotonic time in microseconds at which pending output changes are
+	/// applied, 0 if nothing changed
+	uint64_t monitor_update_us;
+	/// EnterNotify events with a lower serial were caused by our own
+	/// stacking changes, see `Swm__ignore_enter_events`
+	unsigned long enter_ignore_serial;
+	/// Nesting depth of `Swm__grab_server`
+	uint32_t server_grabs;
+	/// Mouse move or resize in progress
+	Drag drag;
+	/// Spawned programs waiting for their window, and their latencies
+	Launches launches;
+	/// Storage of all clients and monitors, see pool.h
+	Pool client_pool;
+	Pool monitor_pool;
 	/// Linked list of all connected monitors
 	Monitor *monitor_list;
 	/// Currently selected monitor
@@ -179,6 +219,13 @@ Monitor *Swm__dir_to_monitor(int dir);
 /// @details TODO: Document this function in detail, and refactor.
 void Swm__drawbar(Monitor *monitor);
 
+/// @brief Draws the bar for a monitor, at most once per frame.
+///
+/// @details For titles which are rewritten many times a second. A change
+/// within a frame of the last redraw is drawn once that frame is over, so
+/// the bar always ends up showing the latest title.
+void Swm__schedule_drawbar(Monitor *monitor);
+
 /// @brief Draws the bar for all monitors.
 void Swm__drawbars(void);
 
@@ -222,6 +269,9 @@ bool Swm__get_text_prop(Window w_id, Atom atom, char *text, uint32_t size);
 ///
 /// @param `client` The client to check for button presses on
 /// @param `focused` Whether or not the client should be focused
+///
+/// @details Sends nothing if the client already has the grabs for `focused`,
+/// see `Client::button_grab`.
 void Swm__grab_buttons(Client *client, bool focused);
 
 /// @brief Sets up all the custom key bindings defined in GLOBAL_KEYBINDINGS
@@ -229,6 +279,11 @@ void Swm__grab_buttons(Client *client, bool focused);
 /// @details This function is called once at startup, and again on mappping notify events.
 void Swm__grab_keys(void);
 
+/// @brief Adds a binding to the end of the dispatch chain of its key.
+///
+/// @details Used by `Swm__grab_keys` to fill `Swm::key_dispatch`.
+void Swm__add_key_dispatch(KeyCode keycode, uint32_t binding);
+
 /// @brief Creates a new client window and manages it.
 ///
 /// @param `w` The window to manage
@@ -247,6 +302,9 @@ Monitor *Swm__rect_to_monitor(int x, int y, int w, int h);
 
 /// @brief Resizes a client with the given dimensions.
 ///
+/// @details Clients which are parked off screen stay parked, only their size
+/// and the remembered position change.
+///
 /// @param `client` The client to resize
 /// @param `x` The x coordinate
 /// @param `y` The y coordinate
@@ -261,11 +319,34 @@ void Swm__resize_client(Client *client, int x, int y, int w, int h);
 /// @param `monitor` The monitor to restack
 void Swm__restack(Monitor *monitor);
 
+/// @brief Grabs the X server, nesting with grabs which are already held.
+///
+/// @details Server grabs don't nest, the first XUngrabServer releases all
+/// of them. An outline drag holds the server while other windows may be
+/// unmanaged, so every grab goes through here.
+void Swm__grab_server(void);
+
+/// @brief Releases a grab of `Swm__grab_server`, the server only once the
+/// outermost grab is released.
+void Swm__ungrab_server(void);
+
+/// @brief Ignores the EnterNotify events caused by the requests sent so far.
+///
+/// @details Sends a NoOp request and remembers its serial instead of syncing
+/// with the server. Crossing events carry the serial of the last request the
+/// server processed, so anything below the marker was caused by our own
+/// stacking, see `Swm__event_enter_notify`.
+void Swm__ignore_enter_events(void);
+
 /// @brief Runs the main event loop.
 ///
 /// @details This function is called after the window manager has been initialized
 /// and is responsible for handling all X events and running the window manager.
-void Swm__run(void);
+/// Whenever the event queue runs dry, hidden tags are prepared before blocking.
+/// While blocked it also wakes up to supervise the autostart commands.
+///
+/// @param `as` The autostart commands to supervise
+void Swm__run(Autostart *as);
 
 /// @brief Updates the client state property of a client.
 ///
@@ -281,6 +362,38 @@ void Swm__set_client_state(Client *client, int64_t state);
 /// @returns true if the client supports the protocol and the event was sent, false otherwise.
 bool Swm__send_event(Client *client, Atom proto);
 
+/// @brief Reads whether a client takes part in the _NET_WM_SYNC_REQUEST protocol.
+///
+/// @details The client has to list _NET_WM_SYNC_REQUEST in WM_PROTOCOLS and
+/// publish its counter in _NET_WM_SYNC_REQUEST_COUNTER.
+///
+/// @param `client` The client to update
+void Swm__update_sync_counter(Client *client);
+
+/// @brief Announces the next configure of a client through _NET_WM_SYNC_REQUEST.
+///
+/// @details Bumps the sync value, sends the request and arms an alarm which
+/// fires once the client has handled the configure and updated its counter.
+///
+/// @param `client` The client which is about to be configured
+///
+/// @returns true if the client supports the protocol and the request was sent
+bool Swm__sync_request(Client *client);
+
+/// @brief Checks if an event acknowledges the pending sync request of a client.
+///
+/// @param `client` The client waiting for an acknowledgement
+/// @param `event` Any X event
+///
+/// @returns true if the event is the alarm of the client and cleared its pending request
+bool Swm__sync_acknowledged(Client *client, XEvent *event);
+
+/// @brief Checks if a client has to be left alone until it acknowledges its last configure.
+///
+/// @details Requests which are not acknowledged within SYNC_REQUEST_TIMEOUT_MS
+/// are given up on, so a hung client cannot stall an interactive resize.
+bool Swm__sync_waiting(Client *client);
+
 /// @brief Sets the focus to a given client.
 ///
 /// @param `client` The client to set the focus to
@@ -298,9 +411,13 @@ void Swm__setfullscreen(Client *client, int32_t fullscreen);
 /// @param `urgent` The urgent state to set
 void Swm__seturgent(Client *client, int urgent);
 
-/// @brief Shows or hides a client.
+/// @brief Shows or hides every client of a stack.
+///
+/// @details Walks the stack once without recursion. Visible clients are shown
+/// top down and hidden ones are parked off screen bottom up, windows which are
+/// already in place are skipped. All moves go out in a single flush.
 ///
-/// @param `client` The client to show or hide
+/// @param `client` The head of the stack to show or hide
 void Swm__showhide(Client *client);
 
 /// @brief Unfocus the client.
@@ -321,6 +438,14 @@ void Swm__unmanage(Client *client, bool destroyed);
 /// this is done in `Swm__drawbar`.
 void Swm__updatebars(void);
 
+/// @brief Creates the backdrop window of every monitor which has none and
+/// fits the others to their monitor.
+///
+/// @details Backdrops are input only windows below all clients. The pointer
+/// moving over the desktop from one monitor to another enters the backdrop of
+/// the new monitor, so the root does not need to report pointer motion.
+void Swm__update_backdrops(void);
+
 /// @brief Iterates through all clients on all monitors and updates the window properties.
 ///
 /// @details The following X11 functions are called:
@@ -328,22 +453,47 @@ void Swm__updatebars(void);
 ///	- XDeleteProperty: https://tronche.com/gui/x/xlib/window-information/XDeleteProperty.html
 void Swm__update_client_list(void);
 
-/// @brief Update the geometry of the screen
+/// @brief Applies output changes once they settled.
 ///
-/// @details For each monitor, update the width and height of the monitor
-/// based of the screen width and height. Then update the bar position,
-/// and map the current monitor to the root window id.
+/// @details Every call restarts a MONITOR_SETTLE_MS window, the main loop
+/// calls `Swm__update_monitors` once it passes without further changes.
+void Swm__schedule_monitor_update(void);
+
+/// @brief Matches the monitors, bars and fullscreen clients to the outputs
+/// and re-arranges everything if anything changed.
+void Swm__update_monitors(void);
+
+/// @brief Update the monitors to match the physical monitors
+///
+/// @details The geometries from `Randr__monitor_geometries` are diffed
+/// against the monitor list: monitors keeping their geometry are untouched,
+/// changed ones get the new geometry and bar position, new geometries add
+/// monitors, and the clients of removed monitors move to the first monitor.
+///
+/// @returns true if any monitor was added, removed or changed
 bool Swm__updategeom(void);
 
-/// @brief Updates the numlock mask
-/// TODO: Better documentation
-void Swm__update_numlock_mask(void);
+/// @brief Looks up which modifier NumLock is mapped to.
+///
+/// @details Costs a round trip, only called at startup and on MappingNotify.
+///
+/// @returns true if the numlock mask changed
+bool Swm__update_numlock_mask(void);
+
+/// @brief Grabs the buttons of every client again, after the numlock mask
+/// changed.
+void Swm__regrab_buttons(void);
 
 /// @brief Update the status text in the bar
 void Swm__update_status(void);
 
 /// @brief Update the title of a client, which is displayed in the center of the bar.
-void Swm__update_client_title(Client *client);
+///
+/// @details _NET_WM_NAME is read as UTF8_STRING with a single request and
+/// used as is. Other encodings and WM_NAME go through `Swm__get_text_prop`.
+///
+/// @returns true if the title changed
+bool Swm__update_client_title(Client *client);
 
 /// @brief Updates the type of window, is it floating or fullscreen.
 ///
@@ -0,0 +1,47 @@
+// Standard Libraries
+#include <stdio.h>
+#include <time.h>
+
+// Slacker Headers
+#include "timing.h"
+
+uint64_t Timing__now_us(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void TimingStats__record(TimingStats *stats, uint64_t duration_us)
+{
+	if (!stats) {
+		return;
+	}
+
+	if (stats->count == 0 || duration_us < stats->min_us) {
+		stats->min_us = duration_us;
+	}
+	if (duration_us > stats->max_us) {
+		stats->max_us = duration_us;
+	}
+	stats->last_us = duration_us;
+	stats->total_us += duration_us;
+	stats->count++;
+}
+
+void TimingStats__log(const TimingStats *stats)
+{
+#if (DEBUG == 1)
+	if (!stats || stats->count == 0) {
+		return;
+	}
+
+	fprintf(stdout,
+		"%s: last %.3f ms, avg %.3f ms, min %.3f ms, max %.3f ms, n=%lu\n",
+		stats->name, stats->last_us / 1000.0,
+		(double)stats->total_us / stats->count / 1000.0,
+		stats->min_us / 1000.0, stats->max_us / 1000.0,
+		(unsigned long)stats->count);
+#endif
+}
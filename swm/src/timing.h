@@ -0,0 +1,35 @@
+#ifndef SWM_TIMING_H
+#define SWM_TIMING_H
+
+// Standard Libraries
+#include <stdint.h>
+
+typedef struct TimingStats TimingStats;
+
+/// @brief Running statistics over a series of measured durations.
+///
+/// @details Zero initialize with a name, e.g `TimingStats s = { "view" };`
+struct TimingStats {
+	/// Name used when logging
+	const char *name;
+	/// Number of recorded samples
+	uint64_t count;
+	/// Sum, minimum, maximum and most recent sample in microseconds
+	uint64_t total_us, min_us, max_us, last_us;
+};
+
+/// @brief Reads the monotonic clock.
+///
+/// @returns The current time in microseconds
+uint64_t Timing__now_us(void);
+
+/// @brief Adds one sample to the statistics.
+///
+/// @param `stats` The statistics to update
+/// @param `duration_us` The measured duration in microseconds
+void TimingStats__record(TimingStats *stats, uint64_t duration_us);
+
+/// @brief Prints the statistics to stdout, only in debug builds.
+void TimingStats__log(const TimingStats *stats);
+
+#endif
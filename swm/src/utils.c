@@ -1,4 +1,10 @@
+// POSIX_SPAWN_SETSID
+#define _GNU_SOURCE
+
 // Standard Library
+#include <errno.h>
+#include <signal.h>
+#include <spawn.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -11,6 +17,21 @@
 
 const char CLIENT_WINDOW_BROKEN[] = "broken";
 
+uint64_t fnv1a(uint64_t hash, const void *data, size_t size)
+{
+	const uint8_t *bytes = data;
+
+	for (size_t i = 0; i < size; ++i) {
+		hash = (hash ^ bytes[i]) * 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+uint64_t fnv1a_string(const char *text)
+{
+	return fnv1a(FNV1A_OFFSET_BASIS, text, strlen(text));
+}
+
 void die(const char *fmt, ...)
 {
 	va_list ap;
@@ -54,23 +75,49 @@ void clean_environment(void)
 	}
 }
 
+int32_t spawn_process(char *const argv[], pid_t *pid)
+{
+	extern char **environ;
+	posix_spawnattr_t attr;
+	sigset_t sigdefault;
+	sigset_t sigmask;
+	int32_t err = 0;
+
+	// The child starts its own session with SIGCHLD back at the default
+	// and nothing blocked, whatever our handler for it is.
+	sigemptyset(&sigdefault);
+	sigaddset(&sigdefault, SIGCHLD);
+	sigemptyset(&sigmask);
+
+	posix_spawnattr_init(&attr);
+	posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSID |
+						POSIX_SPAWN_SETSIGDEF |
+						POSIX_SPAWN_SETSIGMASK);
+	posix_spawnattr_setsigdefault(&attr, &sigdefault);
+	posix_spawnattr_setsigmask(&attr, &sigmask);
+
+	// Shares our memory until the exec, so the cost doesn't grow with
+	// the font caches and pixmaps like fork does.
+	err = posix_spawnp(pid, argv[0], NULL, &attr, argv, environ);
+	posix_spawnattr_destroy(&attr);
+
+	// The caller reports the failure, it knows what was started
+	if (err) {
+		errno = err;
+		*pid = -1;
+		return -1;
+	}
+	return 0;
+}
+
 int32_t system_exec(const char *cmdstring, pid_t *pid)
 {
-	int32_t status = 0;
+	char *argv[] = { "/bin/sh", "-c", (char *)cmdstring, NULL };
 
 	if (cmdstring == NULL) {
 		// always a command processor with UNIX
 		return (1);
 	}
 
-	if ((*pid = fork()) < 0) {
-		// probably out of processes
-		status = -1;
-	} else if (*pid == 0) {
-		execl("/bin/sh", "sh", "-c", cmdstring, (char *)0);
-		// execl error
-		_exit(127);
-	}
-
-	return (status);
+	return spawn_process(argv, pid);
 }
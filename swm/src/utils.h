@@ -2,6 +2,7 @@
 #define SWM_UTILS_H
 
 // Standard Libraries
+#include <stdint.h>
 #include <stdlib.h>
 
 // Slacker Libraries
@@ -17,6 +18,9 @@
 #define BETWEEN(X, A, B) ((A) <= (X) && (X) <= (B))
 #define LENGTH(X) (sizeof X / sizeof X[0])
 
+/// Offset basis of the 64 bit FNV-1a hash, the hash of nothing
+#define FNV1A_OFFSET_BASIS 0xcbf29ce484222325ULL
+
 ////////////////////////////////////////////////////
 /// 			Helper client macros
 ////////////////////////////////////////////////////
@@ -36,6 +40,11 @@ struct NumTagsCompileTimeCheck {
 	uint32_t limitexceeded[LENGTH(G_TAGS) > MAX_SUPPORTED_TAGS ? -1 : 1];
 };
 
+/// @brief Compile time check to ensure key binding indices fit the dispatch table
+struct KeyBindingsCompileTimeCheck {
+	uint32_t limitexceeded[MAX_KEY_BINDINGS >= UINT8_MAX ? -1 : 1];
+};
+
 /// Client text which displays in the bar when the client is broken
 // TODO: Move this into the Client struct
 extern const char CLIENT_WINDOW_BROKEN[];
@@ -46,11 +55,33 @@ void die(const char *fmt, ...);
 /// @brief Allocate memory and check for errors
 void *ecalloc(size_t nmemb, size_t size);
 
+/// @brief Folds bytes into a 64 bit FNV-1a hash.
+///
+/// @param hash FNV1A_OFFSET_BASIS for a new hash, else the hash so far
+/// @param data The bytes to add
+/// @param size The number of bytes
+uint64_t fnv1a(uint64_t hash, const void *data, size_t size);
+
+/// @brief 64 bit FNV-1a hash of a string, without its terminator.
+uint64_t fnv1a_string(const char *text);
+
 /// @brief Clean up the environment inherited from the parent process.
 ///
 /// @details Private function, only called once in `Slacker__init`
 void clean_environment(void);
 
+/// @brief Start a program in a new session with posix_spawn.
+///
+/// @details Doesn't fork the window manager, the child shares our memory
+/// until it execs. Searches PATH like execvp.
+///
+/// @param argv The program and its arguments, NULL terminated.
+/// @param pid Set to the process id of the child, -1 on failure.
+///
+/// @return 0 on success, -1 with errno set if the program could not be
+/// started
+int32_t spawn_process(char *const argv[], pid_t *pid);
+
 /// @brief Execute a shell command in a child process.
 ///
 /// @details Doesn't block the main process, and returns the status of the command.
@@ -0,0 +1,123 @@
+/// Focus cycle stress test, built and run by `make test`.
+///
+/// Cycles the focus through 1000 clients on a monitor which only exists in
+/// memory, moving every client to the top of the stack the way `Swm__focus`
+/// does. Then checks that both lists are linked the same way in both
+/// directions, that the client list kept its order and that the stack ends
+/// up in reverse list order.
+
+// Standard Libraries
+#include <stdint.h>
+#include <stdio.h>
+
+// Slacker Headers
+#include "client.h"
+#include "monitor.h"
+#include "pool.h"
+#include "swm.h"
+#include "timing.h"
+
+#define TEST_CLIENTS 1000
+#define TEST_ROUNDS 100
+
+/// @returns The length of the client list, -1 if a prev link is broken
+static int32_t list_length(const Monitor *monitor)
+{
+	int32_t n = 0;
+	const Client *prev = NULL;
+
+	for (const Client *c = monitor->client_list; c;
+	     prev = c, c = c->next, ++n) {
+		if (c->prev != prev) {
+			return -1;
+		}
+	}
+	return n;
+}
+
+/// @returns The length of the stack, -1 if a stack_prev link is broken
+static int32_t stack_length(const Monitor *monitor)
+{
+	int32_t n = 0;
+	const Client *prev = NULL;
+
+	for (const Client *c = monitor->client_stack; c;
+	     prev = c, c = c->stack_next, ++n) {
+		if (c->stack_prev != prev) {
+			return -1;
+		}
+	}
+	return n;
+}
+
+int main(void)
+{
+	Monitor *monitor = NULL;
+	Client *c = NULL;
+	Client *s = NULL;
+	uint64_t start_us = 0;
+	uint64_t cycle_us = 0;
+	int32_t failed = 0;
+
+	Pool__init(&g_swm.client_pool, "client", sizeof(Client));
+	Pool__init(&g_swm.monitor_pool, "monitor", sizeof(Monitor));
+	monitor = Monitor__new();
+
+	for (uint32_t i = 0; i < TEST_CLIENTS; ++i) {
+		c = Pool__alloc(&g_swm.client_pool);
+		c->mon = monitor;
+		c->tags = 1;
+		c->win = i;
+		Client__attach(c);
+		Client__attach_to_stack(c);
+	}
+
+	start_us = Timing__now_us();
+	for (uint32_t round = 0; round < TEST_ROUNDS; ++round) {
+		for (c = monitor->client_list; c; c = c->next) {
+			Client__detach_from_stack(c);
+			Client__attach_to_stack(c);
+		}
+	}
+	cycle_us = Timing__now_us() - start_us;
+
+	if (list_length(monitor) != TEST_CLIENTS ||
+	    stack_length(monitor) != TEST_CLIENTS) {
+		fprintf(stderr, "focus cycle: a list lost clients or links\n");
+		failed = 1;
+	}
+	// The first window attached is at the end of the list
+	for (c = monitor->client_list, s = monitor->client_stack;
+	     !failed && c; c = c->next, s = s->stack_next) {
+		if (c->win != TEST_CLIENTS - 1 - s->win) {
+			fprintf(stderr,
+				"focus cycle: list or stack out of order\n");
+			failed = 1;
+		}
+	}
+
+	// Detaching from the middle and both ends leaves both lists intact
+	while (!failed && (c = monitor->client_list)) {
+		for (int32_t i = list_length(monitor) / 2; c->next && i > 0;
+		     --i) {
+			c = c->next;
+		}
+		Client__detach(c);
+		Client__detach_from_stack(c);
+		Pool__free(&g_swm.client_pool, c);
+		if (list_length(monitor) < 0 || stack_length(monitor) < 0 ||
+		    list_length(monitor) != stack_length(monitor)) {
+			fprintf(stderr, "focus cycle: detach broke a list\n");
+			failed = 1;
+		}
+	}
+
+	fprintf(stdout, "focus cycle over %u clients: %.2f ns per focus, %s\n",
+		TEST_CLIENTS,
+		cycle_us * 1000.0 / ((double)TEST_ROUNDS * TEST_CLIENTS),
+		failed ? "FAILED" : "ok");
+
+	Pool__delete(&g_swm.client_pool);
+	Pool__delete(&g_swm.monitor_pool);
+	return failed;
+}